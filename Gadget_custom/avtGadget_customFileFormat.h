@@ -44,9 +44,23 @@
 #ifndef AVT_Gadget_custom_FILE_FORMAT_H
 #define AVT_Gadget_custom_FILE_FORMAT_H
 
-#include <avtSTSDFileFormat.h>
+#include <avtSTMDFileFormat.h>
+#include <ByteSwap.h>
+#include <DataExtents.h>
+#include <DepositionGrid.h>
+#include <DerivedFields.h>
+#include <MappedFile.h>
+#include <Prefetcher.h>
+#include <ReadStatistics.h>
+#include <SidecarFile.h>
+#include <SpatialIndex.h>
+#include <Subsample.h>
+#include <VertexCellCache.h>
 #define int4bytes int
 
+class DBOptionsAttributes;
+class vtkFloatArray;
+
 
 // ****************************************************************************
 //  Class: avtGadget_customFileFormat
@@ -57,46 +71,141 @@
 //  Programmer: bwvdnbro -- generated by xml2avt
 //  Creation:   Tue Nov 18 11:19:21 PDT 2014
 //
+//  Modifications:
+//    Bert Vandenbroucke, Sat Oct 17 14:02:33 CEST 2026
+//    The vertex cells of the particle meshes are set up in bulk.
+//
+//    Bert Vandenbroucke, Sat Oct 17 15:10:27 CEST 2026
+//    Changed to an STMD file format with "Number of domains" and
+//    "Peano-Hilbert domains" read options. The latter uses a spatial index
+//    (stored in a sidecar file) to make every domain a spatially compact
+//    bucket, and returns the bucket bounding boxes as spatial extents.
+//
+//    Bert Vandenbroucke, Sat Oct 17 16:02:41 CEST 2026
+//    Added data extents per domain (stored in a sidecar file), so that
+//    VisIt can skip domains based on the values of a variable.
+//
+//    Bert Vandenbroucke, Sat Oct 17 16:48:19 CEST 2026
+//    Added the "Subsample stride" and "Random subsample" read options, which
+//    only load a fraction of the particles.
+//
+//    Bert Vandenbroucke, Sat Oct 17 17:31:06 CEST 2026
+//    The snapshot is memory mapped (until FreeUpResources) and the block
+//    offsets are 64-bit, so that snapshots larger than 2 GiB can be read.
+//
+//    Bert Vandenbroucke, Sat Oct 17 18:14:52 CEST 2026
+//    Added support for snapshots that are split over multiple files
+//    (snapshot_005.0, snapshot_005.1...). Every file is read independently
+//    and is divided in "Number of domains" domains of its own.
+//
+//    Bert Vandenbroucke, Sat Oct 17 18:52:37 CEST 2026
+//    The layout of the Blocks of every file is stored in a sidecar file, so
+//    that a snapshot can be reopened without scanning it.
+//
+//    Bert Vandenbroucke, Sat Oct 17 19:27:45 CEST 2026
+//    The byte order of every file is detected from its first record marker,
+//    and the data of files with the other byte order are swapped on reading.
+//
+//    Bert Vandenbroucke, Sat Oct 17 20:06:13 CEST 2026
+//    Added the derived variables Radius (for all particle types),
+//    Temperature (for the gas) and MASS (for particle types with a mass in
+//    the header).
+//
+//    Bert Vandenbroucke, Sat Oct 17 20:44:58 CEST 2026
+//    Added the "Prefetch next snapshot" read option, which reads the parts
+//    of the next snapshot corresponding to the parts we read from this
+//    snapshot in the background.
+//
+//    Bert Vandenbroucke, Sat Oct 17 23:21:54 CEST 2026
+//    Added ReadStatistics, which are reported to the debug logs and to the
+//    file set with the "Statistics file" read option.
+//
+//    Bert Vandenbroucke, Sun Oct 18 02:03:51 CEST 2026
+//    Added the "Deposition grid resolution" read option and the grid<N>
+//    meshes, onto which the masses (and mass weighted variables) of the
+//    particles are deposited with a DepositionGrid.
+//
 // ****************************************************************************
 
-class avtGadget_customFileFormat : public avtSTSDFileFormat
+class avtGadget_customFileFormat : public avtSTMDFileFormat
 {
   private:
     class Block{
     private:
         std::string _name;
         bool _mesh[6];
-        int _streampos[6];
-        int _streamsize[6];
+        unsigned long long _streampos[6];
+        unsigned long long _streamsize[6];
         bool _vec;
+        bool _swap;
     
     public:
-        Block(std::istream& stream, unsigned int* npart);
+        Block(){}
+        Block(std::istream& stream, unsigned int* npart, bool swap);
+        
+        bool read(SidecarFile& file);
+        void write(SidecarFile& file);
         
         bool is_vec();
         
         std::string get_name();
         bool has_data(unsigned int type);
         
-        void get_data(std::istream& stream, float* data, unsigned int parttype);
+        bool get_data(const MappedFile& file, float* data,
+                      unsigned int parttype,
+                      const SpatialIndex::RunList& runs,
+                      const Subsample& subsample);
+        void get_range(unsigned int parttype,
+                       const SpatialIndex::RunList& runs,
+                       unsigned long long& offset, unsigned long long& size);
+    };
+    
+    class SubFile{
+    public:
+        std::string _name;
+        unsigned int _npart[6];
+        std::vector<Block*> _blocks;
+        MappedFile _file;
+        SpatialIndex _index;
+        
+        SubFile(const std::string& name) : _name(name) {}
+        ~SubFile(){
+            clear_blocks();
+        }
+        
+        void clear_blocks(){
+            for(unsigned int i = 0; i < _blocks.size(); i++){
+                delete _blocks[i];
+            }
+            _blocks.clear();
+        }
     };
 
   public:
-                       avtGadget_customFileFormat(const char *filename);
-    virtual           ~avtGadget_customFileFormat() {;};
+                       avtGadget_customFileFormat(const char *filename,
+                                                DBOptionsAttributes *readOpts);
+    virtual           ~avtGadget_customFileFormat();
 
     virtual const char    *GetType(void)   { return "Gadget_custom"; };
     virtual void           FreeUpResources(void); 
 
-    virtual vtkDataSet    *GetMesh(const char *);
-    virtual vtkDataArray  *GetVar(const char *);
-    virtual vtkDataArray  *GetVectorVar(const char *);
+    virtual vtkDataSet    *GetMesh(int, const char *);
+    virtual vtkDataArray  *GetVar(int, const char *);
+    virtual vtkDataArray  *GetVectorVar(int, const char *);
+    virtual void          *GetAuxiliaryData(const char *var, int domain,
+                                            const char *type, void *args,
+                                            DestructorFunction &);
     virtual bool ReturnsValidCycle() const { return true; }
     virtual int GetCycle(void);
     virtual bool ReturnsValidTime() const { return true; }
     virtual double GetTime(void);
     virtual int GetCycleFromFilename(const char *f) const
     {
+      // ignore the file index of a multi-file snapshot
+      int offset = get_subfile_index_offset(f);
+      if(offset >= 0){
+        return GuessCycle(std::string(f, offset).c_str());
+      }
       return GuessCycle(f);
     }
 
@@ -104,18 +213,70 @@ class avtGadget_customFileFormat : public avtSTSDFileFormat
 //    int4bytes blksize,swap;
 //    unsigned long ntot;
     double _masstab[6];
+    double _boxsize;
     double _redshift;
     double _time;
     std::string _fname;
-    unsigned int _npart[6];
-    std::vector<Block*> _blocks;
+    unsigned long long _nparttot[6];
+    std::vector<SubFile*> _subfiles;
+    VertexCellCache _vertex_cells;
+    unsigned int _ndomain;
+    bool _spatial_index;
+    DataExtents _extents;
+    Subsample _subsample;
+    bool _prefetch;
+    Prefetcher _prefetcher;
+    ReadStatistics _statistics;
+    unsigned int _grid_resolution;
+    std::vector<float> _grid_mass[6];
+    
+    void read_gadget_head(unsigned int* npart, double* massarr, double* time, double* redshift, double* boxsize, unsigned long long* nparttot, int* nfile, bool* swap, std::istream& stream);
+    std::vector<Block*> get_blocks(std::istream& stream, unsigned int* npart,
+                                   bool swap);
+    static int get_subfile_index_offset(const char* f);
+    void find_subfiles(int nfile);
+    SubFile& get_subfile(unsigned int ifile);
+    bool read_block_index(SubFile& subfile);
+    bool write_block_index(SubFile& subfile);
+    Block* get_block(unsigned int ifile, const std::string& name);
+    const MappedFile& get_file(unsigned int ifile);
+    void read_block(unsigned int ifile, const std::string& name, float* data,
+                    unsigned int parttype, const SpatialIndex::RunList& runs,
+                    bool prefetch = true);
+    void prefetch_block(unsigned int ifile, const std::string& name,
+                        unsigned int parttype,
+                        const SpatialIndex::RunList& runs);
     
-    void read_gadget_head(unsigned int* npart, double* massarr, double* time, double* redshift, std::istream& stream);
-    std::vector<Block*> get_blocks(std::istream& stream);
+    unsigned int get_number_of_domains();
+    unsigned int get_runs(int domain, unsigned int parttype,
+                          unsigned int& ifile, SpatialIndex::RunList& runs);
+    void get_tiles(const SpatialIndex::RunList& runs,
+                   unsigned long long tilesize,
+                   std::vector<SpatialIndex::RunList>& tiles,
+                   std::vector<unsigned long long>& tilesizes);
+    SpatialIndex& get_index(unsigned int ifile);
+    DataExtents& get_extents();
+    vtkDataArray* add_extents(int domain, const char* varname,
+                              vtkFloatArray* arr);
+    bool get_derived_var(unsigned int ifile, const std::string& name,
+                         unsigned int parttype,
+                         const SpatialIndex::RunList& runs,
+                         unsigned int npart, float* data,
+                         bool prefetch = true);
+    
+    static bool is_grid(const char* name){
+        return !strncmp(name, "grid", 4);
+    }
+    bool get_grid(DepositionGrid& grid);
+    void deposit(unsigned int parttype, const std::string& name, float* data);
+    const std::vector<float>& get_grid_mass(unsigned int parttype);
     
-    static unsigned int get_blocksize(std::istream& stream){
+    static unsigned int get_blocksize(std::istream& stream, bool swap){
         unsigned int blocksize;
         stream.read(reinterpret_cast<char*>(&blocksize), sizeof(unsigned int));
+        if(swap){
+            blocksize = ByteSwap::swap(blocksize);
+        }
         return blocksize;
     }
 
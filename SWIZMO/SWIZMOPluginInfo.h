@@ -82,6 +82,8 @@ class SWIZMOCommonPluginInfo : public virtual CommonDatabasePluginInfo, public v
     virtual DatabaseType              GetDatabaseType();
     virtual avtDatabase              *SetupDatabase(const char * const *list,
                                                     int nList, int nBlock);
+    virtual DBOptionsAttributes      *GetReadOptions() const;
+    virtual DBOptionsAttributes      *GetWriteOptions() const;
 };
 
 class SWIZMOMDServerPluginInfo : public virtual MDServerDatabasePluginInfo, public virtual SWIZMOCommonPluginInfo
@@ -44,11 +44,26 @@
 #ifndef AVT_SWIZMO_FILE_FORMAT_H
 #define AVT_SWIZMO_FILE_FORMAT_H
 
-#include <avtSTSDFileFormat.h>
+#include <avtSTMDFileFormat.h>
 #include <string.h>
+#include <map>
 #include <vector>
 #include <hdf5.h>
 
+#include <ChunkReader.h>
+#include <ColumnReader.h>
+#include <DataExtents.h>
+#include <DepositionGrid.h>
+#include <DerivedFields.h>
+#include <ParticleIndex.h>
+#include <Prefetcher.h>
+#include <ReadStatistics.h>
+#include <SeriesIndex.h>
+#include <Subsample.h>
+#include <VertexCellCache.h>
+
+class DBOptionsAttributes;
+class vtkFloatArray;
 
 // ****************************************************************************
 //  Class: avtSWIZMOFileFormat
@@ -59,9 +74,89 @@
 //  Programmer: Bert Vandenbroucke
 //  Creation:   Mon Nov 18 14:21:23 PST 2013
 //
+//  Modifications:
+//    Bert Vandenbroucke, Sat Oct 17 10:12:44 CEST 2026
+//    Changed to an STMD file format: every file of a multi-file snapshot
+//    (Header/NumFilesPerSnapshot > 1) is exposed as a separate domain.
+//
+//    Bert Vandenbroucke, Sat Oct 17 11:02:37 CEST 2026
+//    Added the "Domains per file" read option, which splits every file in
+//    contiguous hyperslabs that are read as separate domains.
+//
+//    Bert Vandenbroucke, Sat Oct 17 12:20:51 CEST 2026
+//    Files, headers and datasets are now kept open between calls and are
+//    released in FreeUpResources.
+//
+//    Bert Vandenbroucke, Sat Oct 17 13:05:12 CEST 2026
+//    Tensor rows are read column-selectively, or from a cached full tensor
+//    when more than one row of the same tensor is requested.
+//
+//    Bert Vandenbroucke, Sat Oct 17 14:02:33 CEST 2026
+//    The vertex cells of the particle meshes are set up in bulk.
+//
+//    Bert Vandenbroucke, Sat Oct 17 16:02:41 CEST 2026
+//    Added data extents per domain (stored in a sidecar file), so that
+//    VisIt can skip domains based on the values of a variable.
+//
+//    Bert Vandenbroucke, Sat Oct 17 16:48:19 CEST 2026
+//    Added the "Subsample stride" and "Random subsample" read options, which
+//    only load a fraction of the particles.
+//
+//    Bert Vandenbroucke, Sat Oct 17 20:06:13 CEST 2026
+//    The Radius of the particles and the Temperature of the gas are derived
+//    variables that are computed while reading, instead of expressions.
+//
+//    Bert Vandenbroucke, Sat Oct 17 20:44:58 CEST 2026
+//    Added the "Prefetch next snapshot" read option, which reads the parts
+//    of the next snapshot corresponding to the parts we read from this
+//    snapshot in the background.
+//
+//    Bert Vandenbroucke, Sat Oct 17 21:23:10 CEST 2026
+//    The headers and the lists of datasets of all files are stored in a
+//    SeriesIndex in the snapshot directory, so that files only have to be
+//    opened when data is read from them.
+//
+//    Bert Vandenbroucke, Sat Oct 17 22:04:36 CEST 2026
+//    Added support for 2D snapshots. Coordinates and vectors are read with
+//    the ColumnReader, which pads 2 column datasets to 3 components.
+//
+//    Bert Vandenbroucke, Sat Oct 17 23:21:54 CEST 2026
+//    Added ReadStatistics, which are reported to the debug logs and to the
+//    file set with the "Statistics file" read option.
+//
+//    Bert Vandenbroucke, Sat Oct 17 23:58:12 CEST 2026
+//    Added the "Decompression threads" read option, which decompresses the
+//    chunks of compressed datasets on multiple threads.
+//
+//    Bert Vandenbroucke, Sun Oct 18 01:14:29 CEST 2026
+//    Added the "Tracked particles file" read option and the tracked subset
+//    meshes and variables, which only read the particles with the IDs in
+//    that file, using a ParticleIndex of every file.
+//
+//    Bert Vandenbroucke, Sun Oct 18 02:03:51 CEST 2026
+//    Added the "Deposition grid resolution" read option and the PartTypeN/Grid
+//    meshes, onto which the masses (and mass weighted variables) of the
+//    particles are deposited with a DepositionGrid.
+//
+//    Bert Vandenbroucke, Sun Oct 18 04:07:45 CEST 2026
+//    Particle counts are 64-bit, and the high words of the total particle
+//    numbers are used for single file snapshots with more than 2^32
+//    particles of a type. The SlabReader and RowReader split their rows in
+//    tiles, so that only tile sized buffers are needed next to the VTK
+//    arrays.
+//
+//    Bert Vandenbroucke, Sun Oct 18 05:58:23 CEST 2026
+//    The next snapshot is prefetched once per dataset read instead of once
+//    per tile, and the prefetched ranges are forgotten in FreeUpResources.
+//
+//    Bert Vandenbroucke, Sun Oct 18 06:44:52 CEST 2026
+//    The tiles of a slab share a ChunkReader, which decompresses every chunk
+//    only once. Without OpenMP, compressed datasets are always decompressed
+//    by HDF5.
+//
 // ****************************************************************************
 
-class avtSWIZMOFileFormat : public avtSTSDFileFormat
+class avtSWIZMOFileFormat : public avtSTMDFileFormat
 {
   private:
     enum DataType{
@@ -75,14 +170,18 @@ class avtSWIZMOFileFormat : public avtSTSDFileFormat
     private:
         std::string _name;
         DataType _type;
+        // number of columns
+        unsigned int _size;
 
     public:
-        DataSet(std::string name, unsigned int size) : _name(name) {
+        DataSet(std::string name, unsigned int size)
+            : _name(name), _size(size) {
             _type = UNKNOWN;
             if(size == 1){
                 _type = SCALAR;
             }
-            if(size == 3){
+            // 2D simulations can have 2 component vectors
+            if(size == 2 || size == 3){
                 _type = VECTOR;
             }
             if(size == 9){
@@ -105,6 +204,10 @@ class avtSWIZMOFileFormat : public avtSTSDFileFormat
         std::string get_name(){
             return _name;
         }
+
+        unsigned int get_size(){
+            return _size;
+        }
     };
 
     class DataSetList{
@@ -138,6 +241,17 @@ class avtSWIZMOFileFormat : public avtSTSDFileFormat
             return vectors;
         }
 
+        // number of columns of the dataset with the given name, or 0 if
+        // there is no such dataset
+        unsigned int get_size(const std::string &name){
+            for(unsigned int i = 0; i < _list.size(); i++){
+                if(_list[i].get_name() == name){
+                    return _list[i].get_size();
+                }
+            }
+            return 0;
+        }
+
         std::vector<std::string> get_tensors(){
             std::vector<std::string> tensors;
             for(unsigned int i = 0; i < _list.size(); i++){
@@ -174,20 +288,254 @@ class avtSWIZMOFileFormat : public avtSTSDFileFormat
             return 0;
         }
 
+        DataSetList() {}
+
         DataSetList(hid_t group){
             hsize_t it = 0;
             herr_t status = H5Literate(group, H5_INDEX_NAME, H5_ITER_NATIVE,
                                        &it, DataSetList::fill_list, this);
         }
+
+        void write(SeriesIndex::Record &record){
+            record.write((unsigned int)_list.size());
+            for(unsigned int i = 0; i < _list.size(); i++){
+                record.write(_list[i].get_name());
+                record.write(_list[i].get_size());
+            }
+        }
+
+        bool read(SeriesIndex::Record &record){
+            _list.clear();
+            unsigned int size;
+            if(!record.read(size)){
+                return false;
+            }
+            for(unsigned int i = 0; i < size; i++){
+                std::string name;
+                unsigned int ncolumn;
+                if(!record.read(name) || !record.read(ncolumn)){
+                    return false;
+                }
+                add(name, ncolumn);
+            }
+            return true;
+        }
+    };
+
+    class FileHeader{
+    public:
+        bool _read;
+        double _time;
+        double _box[3];
+        unsigned long long _npart[6];
+        unsigned int _nfile;
+        // number of dimensions (0 if not in the header)
+        unsigned int _ndim;
+        // velocity unit in cm/s (for the temperature)
+        double _unit_velocity;
+        // PartType groups in the file and the datasets they contain
+        bool _group[6];
+        DataSetList _datasets[6];
+
+        FileHeader() : _read(false), _time(0.), _nfile(1), _ndim(0),
+                       _unit_velocity(1.e5) {
+            for(unsigned int i = 0; i < 3; i++){
+                _box[i] = 0.;
+            }
+            for(unsigned int i = 0; i < 6; i++){
+                _npart[i] = 0;
+                _group[i] = false;
+            }
+        }
+
+        void write(SeriesIndex::Record &record);
+        bool read(SeriesIndex::Record &record);
+    };
+
+    class TensorCache{
+    public:
+        // full tensor for all particles in a domain (or NULL)
+        float *_data;
+        // bitmask of the rows that have already been requested
+        unsigned int _rows;
+
+        TensorCache() : _data(NULL), _rows(0) {}
+    };
+
+    // particles of a type that are in the tracked subset
+    class TrackedSelection{
+    public:
+        // false until the tracked particles are looked up
+        bool _built;
+        // number of tracked particles in the snapshot
+        unsigned long long _count;
+        // per file: the rows of the tracked particles (in ascending order)
+        // and their index in the tracked mesh
+        std::vector< std::vector<unsigned long long> > _rows;
+        std::vector< std::vector<unsigned long long> > _positions;
+
+        TrackedSelection() : _built(false), _count(0) {}
     };
 
     inline unsigned int get_particle_type(const char *dsname){
         return dsname[8]-'0';
     }
 
+    // true for the meshes and variables of the tracked subset, which are
+    // called PartTypeN/Tracked/<dataset>
+    static bool is_tracked(const char *name){
+        return !strncmp(name, "PartType", 8) && name[8] != '\0' &&
+               !strncmp(name+9, "/Tracked/", 9);
+    }
+
+    // name of the dataset for a mesh or variable of the tracked subset
+    static std::string get_dataset_name(const char *name){
+        return std::string(name, 9) + std::string(name+17);
+    }
+
+    // true for the meshes and variables of the deposition grids, which are
+    // called PartTypeN/Grid or PartTypeN/Grid/<variable>
+    static bool is_grid(const char *name){
+        return !strncmp(name, "PartType", 8) && name[8] != '\0' &&
+               !strncmp(name+9, "/Grid", 5) &&
+               (name[14] == '\0' || name[14] == '/');
+    }
+
+    // reads the slab of the current domain for the ColumnReader, in one go
+    // or in tiles of (at most) tilesize rows of the subsample
+    class SlabReader{
+    private:
+        avtSWIZMOFileFormat &_format;
+        unsigned long long _offset;
+        unsigned long long _count;
+        // number of rows of the file in a tile
+        unsigned long long _step;
+        // the tiles of a compressed dataset share the decompressed chunks
+        std::map<hid_t, ChunkReader*> _chunks;
+
+        ChunkReader *get_chunks(hid_t dataset){
+            if(_format._decompression_threads <= 0){
+                return NULL;
+            }
+            std::map<hid_t, ChunkReader*>::iterator it =
+                _chunks.find(dataset);
+            if(it == _chunks.end()){
+                it = _chunks.insert(std::make_pair(dataset,
+                         new ChunkReader(dataset, _offset + _count))).first;
+            }
+            return it->second;
+        }
+
+        // copying would copy the ChunkReaders
+        SlabReader(const SlabReader&);
+        SlabReader &operator=(const SlabReader&);
+
+    public:
+        SlabReader(avtSWIZMOFileFormat &format, unsigned long long offset,
+                   unsigned long long count,
+                   unsigned long long tilesize = 1 << 16)
+            : _format(format), _offset(offset), _count(count),
+              _step(tilesize*format._subsample.get_stride()) {}
+
+        ~SlabReader(){
+            std::map<hid_t, ChunkReader*>::iterator it;
+            for(it = _chunks.begin(); it != _chunks.end(); ++it){
+                delete it->second;
+            }
+        }
+
+        herr_t operator()(hid_t dataset, hid_t memtype, void *data,
+                          unsigned int column, unsigned int ncolumn){
+            _format.prefetch(dataset, _offset, _count);
+            return _format.read_slab(dataset, memtype, _offset, _count, data,
+                                     column, ncolumn);
+        }
+
+        unsigned int get_ntile() const {
+            return (_count + _step - 1)/_step;
+        }
+
+        unsigned long long get_tile_size(unsigned int itile) const {
+            unsigned long long offset = _offset + itile*_step;
+            return _format._subsample.get_count(offset,
+                       std::min(_step, _offset + _count - offset));
+        }
+
+        herr_t operator()(unsigned int itile, hid_t dataset, hid_t memtype,
+                          void *data, unsigned int column = 0,
+                          unsigned int ncolumn = 0){
+            // the full slab is prefetched with the first tile
+            if(!itile){
+                _format.prefetch(dataset, _offset, _count);
+            }
+            unsigned long long offset = _offset + itile*_step;
+            unsigned long long count = std::min(_step,
+                                                _offset + _count - offset);
+            return _format.read_slab(dataset, memtype, offset, count, data,
+                                     column, ncolumn, get_chunks(dataset));
+        }
+    };
+
+    // reads the given rows of a file for the ColumnReader, in one go or in
+    // tiles of (at most) tilesize rows
+    class RowReader{
+    private:
+        avtSWIZMOFileFormat &_format;
+        const unsigned long long *_rows;
+        unsigned long long _nrow;
+        unsigned long long _tilesize;
+
+    public:
+        RowReader(avtSWIZMOFileFormat &format,
+                  const unsigned long long *rows, unsigned long long nrow,
+                  unsigned long long tilesize = 1 << 16)
+            : _format(format), _rows(rows), _nrow(nrow),
+              _tilesize(tilesize) {}
+
+        herr_t operator()(hid_t dataset, hid_t memtype, void *data,
+                          unsigned int column, unsigned int ncolumn){
+            return _format.read_rows(dataset, memtype, _rows, _nrow, data,
+                                     column, ncolumn);
+        }
+
+        unsigned int get_ntile() const {
+            return (_nrow + _tilesize - 1)/_tilesize;
+        }
+
+        unsigned long long get_tile_size(unsigned int itile) const {
+            return std::min(_tilesize, _nrow - itile*_tilesize);
+        }
+
+        herr_t operator()(unsigned int itile, hid_t dataset, hid_t memtype,
+                          void *data, unsigned int column = 0,
+                          unsigned int ncolumn = 0){
+            return _format.read_rows(dataset, memtype,
+                                     _rows + itile*_tilesize,
+                                     get_tile_size(itile), data, column,
+                                     ncolumn);
+        }
+    };
+
+    // reads the ParticleIDs of a file for the ParticleIndex
+    class IDReader{
+    private:
+        avtSWIZMOFileFormat &_format;
+        unsigned int _ifile;
+
+    public:
+        IDReader(avtSWIZMOFileFormat &format, unsigned int ifile)
+            : _format(format), _ifile(ifile) {}
+
+        void operator()(unsigned int type,
+                        std::vector<unsigned long long> &ids){
+            _format.read_ids(_ifile, type, ids);
+        }
+    };
+
   public:
-                       avtSWIZMOFileFormat(const char *filename);
-    virtual           ~avtSWIZMOFileFormat() {;};
+                       avtSWIZMOFileFormat(const char *filename,
+                                           DBOptionsAttributes *readOpts);
+    virtual           ~avtSWIZMOFileFormat();
 
     virtual bool          ReturnsValidCycle() const { return true; };
     virtual int           GetCycle(void);
@@ -196,28 +544,119 @@ class avtSWIZMOFileFormat : public avtSTSDFileFormat
 
     virtual int GetCycleFromFilename(const char *f) const
     {
-        // we start 3 digits and a .hdf5 extension from the end
+        // we start from the .hdf5 extension at the end and skip the file
+        // index of a multi-file snapshot (snap_0123.0.hdf5), if present
         // we then search for the first non-digit char to find the
         // offset of our cycle number
-        int index = strlen(f)-8;
-        while(isdigit(f[index-1])){
+        int index = get_subfile_index_offset(f);
+        if(index < 0){
+            index = strlen(f)-5;
+        }
+        while(index > 0 && isdigit(f[index-1])){
             index--;
         }
-        unsigned int i;
-        sscanf(&f[index], "%d.hdf5", &i);
+        unsigned int i = 0;
+        sscanf(&f[index], "%u", &i);
         return i;
     }
 
     virtual const char    *GetType(void)   { return "SWIZMO"; };
     virtual void           FreeUpResources(void);
 
-    virtual vtkDataSet    *GetMesh(const char *);
-    virtual vtkDataArray  *GetVar(const char *);
-    virtual vtkDataArray  *GetVectorVar(const char *);
+    virtual vtkDataSet    *GetMesh(int, const char *);
+    virtual vtkDataArray  *GetVar(int, const char *);
+    virtual vtkDataArray  *GetVectorVar(int, const char *);
+
+    virtual void          *GetAuxiliaryData(const char *var, int domain,
+                                            const char *type, void *args,
+                                            DestructorFunction &);
 
   protected:
     std::string _filename;
+    std::vector<std::string> _filenames;
     unsigned int _ndim;
+    unsigned int _nslab;
+    // fraction of the particles that is loaded
+    Subsample _subsample;
+
+    // files, headers and datasets are kept open until FreeUpResources
+    std::vector<hid_t> _files;
+    std::vector<FileHeader> _headers;
+    std::map<std::string, hid_t> _datasets;
+    // file index of every open dataset
+    std::map<hid_t, unsigned int> _dataset_files;
+    // tensors that are requested row by row, per domain
+    std::map<std::string, TensorCache> _tensors;
+    // vertex cells for the particle meshes
+    VertexCellCache _vertex_cells;
+    // value ranges of the variables on the domains
+    DataExtents _extents;
+    // background reads of the next snapshot in the time series
+    bool _prefetch;
+    Prefetcher _prefetcher;
+    // number of threads used to decompress chunked datasets (0: let HDF5
+    // decompress them)
+    int _decompression_threads;
+    // time and bytes spent reading this timestep
+    ReadStatistics _statistics;
+    // IDs of the tracked particles (sorted), read from _tracked_filename
+    std::string _tracked_filename;
+    bool _tracked_read;
+    std::vector<unsigned long long> _tracked;
+    // rows of the tracked particles in this snapshot, per type
+    TrackedSelection _selections[6];
+    // number of cells per dimension of the deposition grids (0: no grids)
+    unsigned int _grid_resolution;
+    // deposited masses on the grid, per type (empty until requested)
+    std::vector<float> _grid_mass[6];
+
+    static int get_subfile_index_offset(const char *f);
+    void find_subfiles();
+
+    static hid_t open_file(const std::string &filename);
+    static void read_header(hid_t file, FileHeader &header);
+    static void read_header(const std::string &filename, hid_t &file,
+                            FileHeader &header);
+    hid_t get_file(unsigned int ifile);
+    FileHeader &get_header(unsigned int ifile);
+    hid_t get_dataset(unsigned int ifile, const std::string &name);
+    void close_files();
+
+    void get_domain(int domain, unsigned int &ifile, unsigned int &islab);
+    void get_slab(unsigned int islab, unsigned long long npart,
+                  unsigned long long &offset, unsigned long long &count);
+    herr_t read_slab(hid_t dataset, hid_t memtype,
+                     unsigned long long offset, unsigned long long count,
+                     void *data, unsigned int column = 0,
+                     unsigned int ncolumn = 0, ChunkReader *chunks = NULL);
+    herr_t read_sample(hid_t dataset, hid_t filespace, int rank,
+                       hid_t memtype, unsigned long long offset,
+                       unsigned long long count, void *data,
+                       unsigned int column, unsigned int ncolumn);
+    herr_t read_rows(hid_t dataset, hid_t memtype,
+                     const unsigned long long *rows, unsigned long long nrow,
+                     void *data, unsigned int column, unsigned int ncolumn);
+    void prefetch(hid_t dataset, unsigned long long offset,
+                  unsigned long long count);
+    void check_read(herr_t status, unsigned int ifile);
+    DataExtents &get_extents();
+    template<typename Reader>
+    void get_derived_var(unsigned int ifile, const char *varname,
+                         Reader &reader, unsigned long long npart,
+                         float *data);
+
+    void read_tracked_list();
+    void read_ids(unsigned int ifile, unsigned int type,
+                  std::vector<unsigned long long> &ids);
+    TrackedSelection &get_tracked_selection(int domain, unsigned int ip);
+    void read_tracked(unsigned int ip, const std::string &name,
+                      unsigned int column, unsigned int ncolumn,
+                      unsigned int ncomponent, float *data);
+    bool get_grid(DepositionGrid &grid);
+    void deposit(unsigned int ip, const std::string &name, float *data);
+    const std::vector<float> &get_grid_mass(unsigned int ip);
+    vtkDataArray *add_extents(int domain, const char *varname,
+                              vtkFloatArray *arr);
 
     virtual void           PopulateDatabaseMetaData(avtDatabaseMetaData *);
 };
@@ -82,6 +82,8 @@ class ShadowfaxCommonPluginInfo : public virtual CommonDatabasePluginInfo, publi
     virtual DatabaseType              GetDatabaseType();
     virtual avtDatabase              *SetupDatabase(const char * const *list,
                                                     int nList, int nBlock);
+    virtual DBOptionsAttributes      *GetReadOptions() const;
+    virtual DBOptionsAttributes      *GetWriteOptions() const;
 };
 
 class ShadowfaxMDServerPluginInfo : public virtual MDServerDatabasePluginInfo, public virtual ShadowfaxCommonPluginInfo
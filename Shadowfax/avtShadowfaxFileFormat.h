@@ -44,8 +44,24 @@
 #ifndef AVT_Shadowfax_FILE_FORMAT_H
 #define AVT_Shadowfax_FILE_FORMAT_H
 
-#include <avtSTSDFileFormat.h>
+#include <avtSTMDFileFormat.h>
 #include <string.h>
+#include <string>
+#include <map>
+#include <hdf5.h>
+
+#include <ColumnReader.h>
+#include <DataExtents.h>
+#include <DerivedFields.h>
+#include <Prefetcher.h>
+#include <ReadStatistics.h>
+#include <SpatialIndex.h>
+#include <Subsample.h>
+#include <VertexCellCache.h>
+#include <VoronoiMesh.h>
+
+class DBOptionsAttributes;
+class vtkFloatArray;
 
 
 // ****************************************************************************
@@ -57,13 +73,128 @@
 //  Programmer: Bert Vandenbroucke
 //  Creation:   Mon Nov 18 14:21:23 PST 2013
 //
+//  Modifications:
+//    Bert Vandenbroucke, Sat Oct 17 11:02:37 CEST 2026
+//    Changed to an STMD file format with a "Number of domains" read option
+//    that splits the datasets in contiguous hyperslabs, one per domain.
+//
+//    Bert Vandenbroucke, Sat Oct 17 12:20:51 CEST 2026
+//    The file, header and datasets are now kept open between calls and are
+//    released in FreeUpResources.
+//
+//    Bert Vandenbroucke, Sat Oct 17 14:02:33 CEST 2026
+//    The vertex cells of the particle meshes are set up in bulk.
+//
+//    Bert Vandenbroucke, Sat Oct 17 15:10:27 CEST 2026
+//    Added the "Peano-Hilbert domains" read option, which uses a spatial
+//    index (stored in a sidecar file) to make every domain a spatially
+//    compact bucket, and return the bucket bounding boxes as spatial extents.
+//
+//    Bert Vandenbroucke, Sat Oct 17 16:02:41 CEST 2026
+//    Added data extents per domain (stored in a sidecar file), so that
+//    VisIt can skip domains based on the values of a variable.
+//
+//    Bert Vandenbroucke, Sat Oct 17 16:48:19 CEST 2026
+//    Added the "Subsample stride" and "Random subsample" read options, which
+//    only load a fraction of the cells and particles.
+//
+//    Bert Vandenbroucke, Sat Oct 17 20:06:13 CEST 2026
+//    radius_gas and radius_dm are derived variables that are computed while
+//    reading, instead of expressions.
+//
+//    Bert Vandenbroucke, Sat Oct 17 20:44:58 CEST 2026
+//    Added the "Prefetch next snapshot" read option, which reads the parts
+//    of the next snapshot corresponding to the parts we read from this
+//    snapshot in the background.
+//
+//    Bert Vandenbroucke, Sat Oct 17 22:04:36 CEST 2026
+//    The coordinates and vector variables are read with the ColumnReader,
+//    with a single code path for 2D and 3D snapshots. acceleration_gas can
+//    now also be read from 2D snapshots.
+//
+//    Bert Vandenbroucke, Sat Oct 17 23:21:54 CEST 2026
+//    Added ReadStatistics, which are reported to the debug logs and to the
+//    file set with the "Statistics file" read option.
+//
+//    Bert Vandenbroucke, Sun Oct 18 00:36:47 CEST 2026
+//    The coordinates, vector variables and radii are read in tiles that fit
+//    in the cache, instead of full columns.
+//
+//    Bert Vandenbroucke, Sun Oct 18 03:12:08 CEST 2026
+//    Added the "Voronoi cells" read option, which adds a voronoi_cells mesh
+//    with the Voronoi cells of the generators (constructed in parallel and
+//    cached per timestep) and cell-centered density, pressure and velocity_gas.
+//
+//    Bert Vandenbroucke, Sun Oct 18 04:07:45 CEST 2026
+//    Cell and particle counts are 64-bit. The spatial index is built from
+//    coordinates that are read in tiles, instead of full columns.
+//
+//    Bert Vandenbroucke, Sun Oct 18 05:31:40 CEST 2026
+//    The Voronoi cells are constructed and cached per domain, from the
+//    generators of the domain and a halo of generators around it, instead
+//    of for all domains on every rank.
+//
+//    Bert Vandenbroucke, Sun Oct 18 05:58:23 CEST 2026
+//    The next snapshot is prefetched once per dataset read instead of once
+//    per tile, and the prefetched ranges are forgotten in FreeUpResources.
+//
 // ****************************************************************************
 
-class avtShadowfaxFileFormat : public avtSTSDFileFormat
+class avtShadowfaxFileFormat : public avtSTMDFileFormat
 {
+  private:
+    class FileHeader{
+    public:
+        bool _read;
+        double _time;
+        unsigned int _ndim;
+        unsigned long long _npart[2];
+
+        FileHeader() : _read(false), _time(0.), _ndim(0) {
+            _npart[0] = 0;
+            _npart[1] = 0;
+        }
+    };
+
+    // reads the runs of the current domain for the ColumnReader, in tiles
+    // of at most tilesize cells or particles (that are in the subsample)
+    class RunReader{
+    private:
+        avtShadowfaxFileFormat &_format;
+        const SpatialIndex::RunList &_runs;
+        std::vector<SpatialIndex::RunList> _tiles;
+        std::vector<unsigned long long> _tilesizes;
+
+    public:
+        RunReader(avtShadowfaxFileFormat &format,
+                  const SpatialIndex::RunList &runs,
+                  unsigned long long tilesize = 1 << 16)
+            : _format(format), _runs(runs) {
+            _format.get_tiles(runs, tilesize, _tiles, _tilesizes);
+        }
+
+        unsigned int get_ntile() const {
+            return _tiles.size();
+        }
+
+        unsigned long long get_tile_size(unsigned int itile) const {
+            return _tilesizes[itile];
+        }
+
+        herr_t operator()(unsigned int itile, hid_t dataset, hid_t memtype,
+                          void *data){
+            // all runs are prefetched with the first tile
+            if(!itile){
+                _format.prefetch(dataset, _runs);
+            }
+            return _format.read_runs(dataset, memtype, _tiles[itile], data);
+        }
+    };
+
   public:
-                       avtShadowfaxFileFormat(const char *filename);
-    virtual           ~avtShadowfaxFileFormat() {;};
+                       avtShadowfaxFileFormat(const char *filename,
+                                              DBOptionsAttributes *readOpts);
+    virtual           ~avtShadowfaxFileFormat();
     
     virtual bool          ReturnsValidCycle() const { return true; };
     virtual int           GetCycle(void);
@@ -87,13 +218,86 @@ class avtShadowfaxFileFormat : public avtSTSDFileFormat
     virtual const char    *GetType(void)   { return "Shadowfax"; };
     virtual void           FreeUpResources(void); 
 
-    virtual vtkDataSet    *GetMesh(const char *);
-    virtual vtkDataArray  *GetVar(const char *);
-    virtual vtkDataArray  *GetVectorVar(const char *);
+    virtual vtkDataSet    *GetMesh(int, const char *);
+    virtual vtkDataArray  *GetVar(int, const char *);
+    virtual vtkDataArray  *GetVectorVar(int, const char *);
+
+    virtual void          *GetAuxiliaryData(const char *var, int domain,
+                                            const char *type, void *args,
+                                            DestructorFunction &);
 
   protected:
-    const char* _filename;
+    std::string _filename;
     unsigned int _ndim;
+    unsigned int _ndomain;
+    bool _spatial_index;
+    SpatialIndex _index;
+    // fraction of the cells and particles that is loaded
+    Subsample _subsample;
+    hid_t _file;
+    FileHeader _header;
+    std::map<std::string, hid_t> _datasets;
+    VertexCellCache _vertex_cells;
+    // value ranges of the variables on the domains
+    DataExtents _extents;
+    // background reads of the next snapshot in the time series
+    bool _prefetch;
+    Prefetcher _prefetcher;
+    // timings of the reads, reported in FreeUpResources
+    ReadStatistics _statistics;
+    // Voronoi cells of the generators of the domains that were requested,
+    // and the box (xmin, xmax, ymin, ymax, zmin, zmax) they are clipped to
+    bool _voronoi;
+    std::map<int, VoronoiMesh> _voronoi_meshes;
+    double _voronoi_box[6];
+
+    hid_t get_file();
+    FileHeader &get_header();
+    hid_t get_dataset(const std::string &name);
+    void close_file();
+    void get_slab(int domain, unsigned long long npart,
+                  unsigned long long &offset, unsigned long long &count);
+    herr_t read_slab(hid_t dataset, hid_t memtype, unsigned long long offset,
+                     unsigned long long count, void *data,
+                     unsigned int stride = 1);
+    herr_t read_runs(hid_t dataset, hid_t memtype,
+                     const SpatialIndex::RunList &runs, void *data);
+    herr_t read_sample(hid_t dataset, hid_t memtype,
+                       const SpatialIndex::RunList &runs, void *data);
+    void get_tiles(const SpatialIndex::RunList &runs,
+                   unsigned long long tilesize,
+                   std::vector<SpatialIndex::RunList> &tiles,
+                   std::vector<unsigned long long> &tilesizes);
+    void prefetch(hid_t dataset, const SpatialIndex::RunList &runs);
+    void check_read(herr_t status);
+    unsigned long long get_runs(int domain, unsigned int type,
+                                unsigned long long npart,
+                                SpatialIndex::RunList &runs);
+    SpatialIndex &get_index();
+    DataExtents &get_extents();
+    vtkDataArray *add_extents(int domain, const char *varname,
+                              vtkFloatArray *arr);
+    void get_radius(unsigned int type, const SpatialIndex::RunList &runs,
+                    float *data);
+    void get_generators(int domain, const double *region,
+                        std::vector<float> *positions, double *box);
+    const double *get_voronoi_box();
+    VoronoiMesh &get_voronoi(int domain);
+
+    // 1 for the dark matter mesh and variables, 0 for the cells
+    static unsigned int get_particle_type(const char *name){
+        if(!strcmp(name, "dark_matter") || !strcmp(name, "velocity_dm") ||
+           !strcmp(name, "radius_dm")){
+            return 1;
+        }
+        return 0;
+    }
+
+    // true for the Voronoi cell mesh and its variables, which are the
+    // generator variables with a "voronoi_" prefix
+    static bool is_voronoi(const char *name){
+        return !strncmp(name, "voronoi_", 8);
+    }
 
     virtual void           PopulateDatabaseMetaData(avtDatabaseMetaData *);
 };
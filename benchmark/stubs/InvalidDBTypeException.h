@@ -0,0 +1 @@
+#include "avtStubs.h"
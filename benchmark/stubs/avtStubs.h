@@ -0,0 +1,386 @@
+/*****************************************************************************
+*
+* Copyright (c) 2000 - 2013, Lawrence Livermore National Security, LLC
+* Produced at the Lawrence Livermore National Laboratory
+* LLNL-CODE-442911
+* All rights reserved.
+*
+* This file is  part of VisIt. For  details, see https://visit.llnl.gov/.  The
+* full copyright notice is contained in the file COPYRIGHT located at the root
+* of the VisIt distribution or at http://www.llnl.gov/visit/copyright.html.
+*
+* Redistribution  and  use  in  source  and  binary  forms,  with  or  without
+* modification, are permitted provided that the following conditions are met:
+*
+*  - Redistributions of  source code must  retain the above  copyright notice,
+*    this list of conditions and the disclaimer below.
+*  - Redistributions in binary form must reproduce the above copyright notice,
+*    this  list of  conditions  and  the  disclaimer (as noted below)  in  the
+*    documentation and/or other materials provided with the distribution.
+*  - Neither the name of  the LLNS/LLNL nor the names of  its contributors may
+*    be used to endorse or promote products derived from this software without
+*    specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT  HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR  IMPLIED WARRANTIES, INCLUDING,  BUT NOT  LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND  FITNESS FOR A PARTICULAR  PURPOSE
+* ARE  DISCLAIMED. IN  NO EVENT  SHALL LAWRENCE  LIVERMORE NATIONAL  SECURITY,
+* LLC, THE  U.S.  DEPARTMENT OF  ENERGY  OR  CONTRIBUTORS BE  LIABLE  FOR  ANY
+* DIRECT,  INDIRECT,   INCIDENTAL,   SPECIAL,   EXEMPLARY,  OR   CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT  LIMITED TO, PROCUREMENT OF  SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF  USE, DATA, OR PROFITS; OR  BUSINESS INTERRUPTION) HOWEVER
+* CAUSED  AND  ON  ANY  THEORY  OF  LIABILITY,  WHETHER  IN  CONTRACT,  STRICT
+* LIABILITY, OR TORT  (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY  WAY
+* OUT OF THE  USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+* DAMAGE.
+*
+*****************************************************************************/
+
+
+
+// ************************************************************************* //
+//                                avtStubs.h                                 //
+// ************************************************************************* //
+
+#ifndef AVT_STUBS_H
+#define AVT_STUBS_H
+
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <vtkStubs.h>
+
+using std::cerr;
+using std::endl;
+
+
+// ****************************************************************************
+//  Classes: avtStubs
+//
+//  Purpose:
+//      Minimal stand-ins for the VisIt classes the plugins use, so that the
+//      readers can be built into the benchmark without VisIt.
+//
+//  Programmer: Bert Vandenbroucke
+//  Creation:   Sat Oct 17 22:43:27 CEST 2026
+//
+//  The file format base classes only provide what a database plugin sees of
+//  them (the file names, the metadata and the cycle guessing), the metadata
+//  classes are plain structs with the members the plugins fill in, and the
+//  read options are stored by type, with their names in the order in which
+//  they were added. The debug streams write to stderr if the environment
+//  variable VISIT_BENCHMARK_DEBUG is set, and are discarded otherwise.
+//
+//  Modifications:
+//    Bert Vandenbroucke, Sun Oct 18 02:03:51 CEST 2026
+//    Added AVT_RECTILINEAR_MESH, for the deposition grids.
+//
+//    Bert Vandenbroucke, Sun Oct 18 03:12:08 CEST 2026
+//    Added AVT_UNSTRUCTURED_MESH, for the Voronoi cells.
+//
+// ****************************************************************************
+
+// exceptions
+
+class VisItException : public std::runtime_error
+{
+  public:
+    VisItException(const std::string &message)
+        : std::runtime_error(message) {}
+};
+
+class BadDomainException : public VisItException
+{
+  public:
+    BadDomainException(int /*domain*/, int /*ndomain*/)
+        : VisItException("Bad domain") {}
+};
+
+class InvalidDBTypeException : public VisItException
+{
+  public:
+    InvalidDBTypeException(const std::string &message)
+        : VisItException(message) {}
+};
+
+class InvalidFilesException : public VisItException
+{
+  public:
+    InvalidFilesException(const std::string &filename)
+        : VisItException("Invalid file: " + filename) {}
+};
+
+class InvalidVariableException : public VisItException
+{
+  public:
+    InvalidVariableException(const std::string &name)
+        : VisItException("Invalid variable: " + name) {}
+};
+
+#define EXCEPTION1(e, a) throw e(a)
+#define EXCEPTION2(e, a, b) throw e(a, b)
+
+// debug streams
+
+inline std::ostream &get_debug_stream(){
+    static std::ofstream discard;
+    if(getenv("VISIT_BENCHMARK_DEBUG")){
+        return cerr;
+    }
+    return discard;
+}
+
+#define debug1 get_debug_stream()
+#define debug2 get_debug_stream()
+#define debug3 get_debug_stream()
+#define debug4 get_debug_stream()
+#define debug5 get_debug_stream()
+
+// read options
+
+class DBOptionsAttributes
+{
+  private:
+    std::vector<std::string> _names;
+    std::map<std::string, bool> _bools;
+    std::map<std::string, int> _ints;
+    std::map<std::string, std::string> _strings;
+
+    void add_name(const std::string &name){
+        for(unsigned int i = 0; i < _names.size(); i++){
+            if(_names[i] == name){
+                return;
+            }
+        }
+        _names.push_back(name);
+    }
+
+  public:
+    int GetNumberOfOptions() const { return _names.size(); }
+    const std::string &GetName(int index) const { return _names[index]; }
+
+    bool HasBool(const std::string &name) const{
+        return _bools.count(name) > 0;
+    }
+    void SetBool(const std::string &name, bool value){
+        add_name(name);
+        _bools[name] = value;
+    }
+    bool GetBool(const std::string &name) const{
+        return _bools.find(name)->second;
+    }
+
+    bool HasInt(const std::string &name) const{
+        return _ints.count(name) > 0;
+    }
+    void SetInt(const std::string &name, int value){
+        add_name(name);
+        _ints[name] = value;
+    }
+    int GetInt(const std::string &name) const{
+        return _ints.find(name)->second;
+    }
+
+    bool HasString(const std::string &name) const{
+        return _strings.count(name) > 0;
+    }
+    void SetString(const std::string &name, const std::string &value){
+        add_name(name);
+        _strings[name] = value;
+    }
+    const std::string &GetString(const std::string &name) const{
+        return _strings.find(name)->second;
+    }
+};
+
+// metadata
+
+enum avtMeshType { AVT_RECTILINEAR_MESH, AVT_UNSTRUCTURED_MESH, AVT_POINT_MESH,
+                   AVT_UNKNOWN_MESH };
+enum avtVarType { AVT_MESH, AVT_SCALAR_VAR, AVT_VECTOR_VAR, AVT_UNKNOWN_TYPE };
+enum avtCentering { AVT_NODECENT, AVT_ZONECENT };
+
+struct avtMeshMetaData
+{
+    std::string name;
+    int spatialDimension;
+    int topologicalDimension;
+    avtMeshType meshType;
+    int numBlocks;
+    std::string blockTitle;
+    std::string blockPieceName;
+
+    avtMeshMetaData() : spatialDimension(3), topologicalDimension(0),
+        meshType(AVT_UNKNOWN_MESH), numBlocks(1) {}
+};
+
+struct avtVarMetaData
+{
+    std::string name;
+    std::string meshName;
+    avtCentering centering;
+    bool hasUnits;
+    std::string units;
+
+    avtVarMetaData() : centering(AVT_NODECENT), hasUnits(false) {}
+};
+
+struct avtScalarMetaData : public avtVarMetaData {};
+
+struct avtVectorMetaData : public avtVarMetaData
+{
+    int varDim;
+
+    avtVectorMetaData() : varDim(3) {}
+};
+
+class Expression {};
+
+class avtDatabaseMetaData
+{
+  public:
+    std::vector<avtMeshMetaData*> meshes;
+    std::vector<avtScalarMetaData*> scalars;
+    std::vector<avtVectorMetaData*> vectors;
+
+    ~avtDatabaseMetaData(){
+        for(unsigned int i = 0; i < meshes.size(); i++){
+            delete meshes[i];
+        }
+        for(unsigned int i = 0; i < scalars.size(); i++){
+            delete scalars[i];
+        }
+        for(unsigned int i = 0; i < vectors.size(); i++){
+            delete vectors[i];
+        }
+    }
+
+    void Add(avtMeshMetaData *mesh) { meshes.push_back(mesh); }
+    void Add(avtScalarMetaData *scalar) { scalars.push_back(scalar); }
+    void Add(avtVectorMetaData *vector) { vectors.push_back(vector); }
+
+    avtVarType DetermineVarType(const std::string &name) const{
+        for(unsigned int i = 0; i < meshes.size(); i++){
+            if(meshes[i]->name == name){
+                return AVT_MESH;
+            }
+        }
+        for(unsigned int i = 0; i < scalars.size(); i++){
+            if(scalars[i]->name == name){
+                return AVT_SCALAR_VAR;
+            }
+        }
+        for(unsigned int i = 0; i < vectors.size(); i++){
+            if(vectors[i]->name == name){
+                return AVT_VECTOR_VAR;
+            }
+        }
+        return AVT_UNKNOWN_TYPE;
+    }
+};
+
+// auxiliary data
+
+typedef void (*DestructorFunction)(void *);
+
+#define AUXILIARY_DATA_DATA_EXTENTS "DATA_EXTENTS"
+#define AUXILIARY_DATA_SPATIAL_EXTENTS "SPATIAL_EXTENTS"
+
+class avtIntervalTree
+{
+  private:
+    int _nelement;
+    int _ndim;
+    std::vector<double> _bounds;
+
+  public:
+    avtIntervalTree(int nelement, int ndim)
+        : _nelement(nelement), _ndim(ndim), _bounds(2*nelement*ndim) {}
+
+    void AddElement(int element, const double *bounds){
+        for(int i = 0; i < 2*_ndim; i++){
+            _bounds[2*_ndim*element+i] = bounds[i];
+        }
+    }
+    void Calculate(bool = false) {}
+
+    static void Destruct(void *tree){
+        delete (avtIntervalTree*)tree;
+    }
+};
+
+// file formats
+
+class avtFileFormat
+{
+  protected:
+    avtDatabaseMetaData *metadata;
+
+    int GuessCycle(const char *filename, const char * = NULL) const{
+        // the last sequence of digits in the file name
+        const char *end = filename + strlen(filename);
+        while(end > filename && !isdigit(end[-1])){
+            end--;
+        }
+        const char *begin = end;
+        while(begin > filename && isdigit(begin[-1])){
+            begin--;
+        }
+        return begin == end ? -1 : atoi(begin);
+    }
+
+  public:
+    avtFileFormat() : metadata(NULL) {}
+    virtual ~avtFileFormat() {}
+
+    void SetDatabaseMetaData(avtDatabaseMetaData *md) { metadata = md; }
+
+    virtual int GetCycleFromFilename(const char *filename) const{
+        return GuessCycle(filename);
+    }
+    virtual bool ReturnsValidCycle() const { return false; }
+    virtual int GetCycle(void) { return -1; }
+    virtual bool ReturnsValidTime() const { return false; }
+    virtual double GetTime(void) { return 0.; }
+
+    virtual const char *GetType(void) = 0;
+    virtual void ActivateTimestep(void) {}
+    virtual void FreeUpResources(void) {}
+    virtual void PopulateDatabaseMetaData(avtDatabaseMetaData *) = 0;
+};
+
+class avtSTMDFileFormat : public avtFileFormat
+{
+  protected:
+    std::vector<char*> filenames;
+    int nFiles;
+
+  public:
+    avtSTMDFileFormat(const char * const *names, int nnames)
+        : nFiles(nnames){
+        for(int i = 0; i < nnames; i++){
+            filenames.push_back(strdup(names[i]));
+        }
+    }
+    virtual ~avtSTMDFileFormat(){
+        for(unsigned int i = 0; i < filenames.size(); i++){
+            free(filenames[i]);
+        }
+    }
+
+    virtual vtkDataSet *GetMesh(int, const char *) = 0;
+    virtual vtkDataArray *GetVar(int, const char *) = 0;
+    virtual vtkDataArray *GetVectorVar(int, const char *) { return NULL; }
+    virtual void *GetAuxiliaryData(const char *, int, const char *, void *,
+                                   DestructorFunction &) { return NULL; }
+};
+
+#endif
@@ -0,0 +1 @@
+#include <hdf5.h>
@@ -0,0 +1 @@
+#include "vtkStubs.h"
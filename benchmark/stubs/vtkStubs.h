@@ -0,0 +1,365 @@
+/*****************************************************************************
+*
+* Copyright (c) 2000 - 2013, Lawrence Livermore National Security, LLC
+* Produced at the Lawrence Livermore National Laboratory
+* LLNL-CODE-442911
+* All rights reserved.
+*
+* This file is  part of VisIt. For  details, see https://visit.llnl.gov/.  The
+* full copyright notice is contained in the file COPYRIGHT located at the root
+* of the VisIt distribution or at http://www.llnl.gov/visit/copyright.html.
+*
+* Redistribution  and  use  in  source  and  binary  forms,  with  or  without
+* modification, are permitted provided that the following conditions are met:
+*
+*  - Redistributions of  source code must  retain the above  copyright notice,
+*    this list of conditions and the disclaimer below.
+*  - Redistributions in binary form must reproduce the above copyright notice,
+*    this  list of  conditions  and  the  disclaimer (as noted below)  in  the
+*    documentation and/or other materials provided with the distribution.
+*  - Neither the name of  the LLNS/LLNL nor the names of  its contributors may
+*    be used to endorse or promote products derived from this software without
+*    specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT  HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR  IMPLIED WARRANTIES, INCLUDING,  BUT NOT  LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND  FITNESS FOR A PARTICULAR  PURPOSE
+* ARE  DISCLAIMED. IN  NO EVENT  SHALL LAWRENCE  LIVERMORE NATIONAL  SECURITY,
+* LLC, THE  U.S.  DEPARTMENT OF  ENERGY  OR  CONTRIBUTORS BE  LIABLE  FOR  ANY
+* DIRECT,  INDIRECT,   INCIDENTAL,   SPECIAL,   EXEMPLARY,  OR   CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT  LIMITED TO, PROCUREMENT OF  SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF  USE, DATA, OR PROFITS; OR  BUSINESS INTERRUPTION) HOWEVER
+* CAUSED  AND  ON  ANY  THEORY  OF  LIABILITY,  WHETHER  IN  CONTRACT,  STRICT
+* LIABILITY, OR TORT  (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY  WAY
+* OUT OF THE  USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+* DAMAGE.
+*
+*****************************************************************************/
+
+
+
+// ************************************************************************* //
+//                                vtkStubs.h                                 //
+// ************************************************************************* //
+
+#ifndef VTK_STUBS_H
+#define VTK_STUBS_H
+
+#include <cstddef>
+#include <vector>
+
+
+// ****************************************************************************
+//  Classes: vtkStubs
+//
+//  Purpose:
+//      Minimal stand-ins for the VTK classes the plugins use, so that the
+//      readers can be built into the benchmark without VTK.
+//
+//  Programmer: Bert Vandenbroucke
+//  Creation:   Sat Oct 17 22:43:27 CEST 2026
+//
+//  Only the parts of the VTK API that are used by the plugins (and by the
+//  benchmark driver) are provided, with the same names and semantics:
+//  objects are reference counted and are destroyed by the last Delete(), and
+//  data arrays store their tuples contiguously. The implementations are kept
+//  as simple as possible, so that the cost of a GetMesh or GetVar call is the
+//  cost of the plugin itself.
+//
+//  Modifications:
+//    Bert Vandenbroucke, Sun Oct 18 02:03:51 CEST 2026
+//    Added vtkRectilinearGrid, for the deposition grids.
+//
+//    Bert Vandenbroucke, Sun Oct 18 03:12:08 CEST 2026
+//    Added polygon and polyhedron cells, for the Voronoi cells.
+//
+// ****************************************************************************
+
+typedef long long vtkIdType;
+
+#define VTK_VERTEX 1
+#define VTK_POLYGON 7
+#define VTK_POLYHEDRON 42
+
+class vtkObjectBase
+{
+  private:
+    int _refcount;
+
+  public:
+    vtkObjectBase() : _refcount(1) {}
+    virtual ~vtkObjectBase() {}
+
+    void Register(vtkObjectBase *) { ++_refcount; }
+    void UnRegister(vtkObjectBase *) { Delete(); }
+    void Delete(){
+        --_refcount;
+        if(!_refcount){
+            delete this;
+        }
+    }
+    int GetReferenceCount() const { return _refcount; }
+};
+
+class vtkObject : public vtkObjectBase {};
+
+class vtkDataArray : public vtkObject
+{
+  protected:
+    int _ncomponent;
+    vtkIdType _ntuple;
+
+  public:
+    vtkDataArray() : _ncomponent(1), _ntuple(0) {}
+
+    void SetName(const char *) {}
+    void SetNumberOfComponents(int ncomponent) { _ncomponent = ncomponent; }
+    int GetNumberOfComponents() const { return _ncomponent; }
+    vtkIdType GetNumberOfTuples() const { return _ntuple; }
+    void SetNumberOfTuples(vtkIdType ntuple){
+        SetNumberOfValues(ntuple*_ncomponent);
+    }
+
+    virtual void SetNumberOfValues(vtkIdType nvalue) = 0;
+    virtual void *GetVoidPointer(vtkIdType index) = 0;
+    virtual int GetDataTypeSize() const = 0;
+};
+
+template<typename T> class vtkAOSDataArrayTemplate : public vtkDataArray
+{
+  private:
+    std::vector<T> _values;
+
+  public:
+    void SetNumberOfValues(vtkIdType nvalue){
+        _values.resize(nvalue);
+        _ntuple = nvalue/_ncomponent;
+    }
+    void *GetVoidPointer(vtkIdType index) { return GetPointer(index); }
+    T *GetPointer(vtkIdType index){
+        return _values.empty() ? NULL : &_values[index];
+    }
+    int GetDataTypeSize() const { return sizeof(T); }
+};
+
+class vtkFloatArray : public vtkAOSDataArrayTemplate<float>
+{
+  public:
+    static vtkFloatArray *New() { return new vtkFloatArray; }
+};
+
+class vtkDoubleArray : public vtkAOSDataArrayTemplate<double>
+{
+  public:
+    static vtkDoubleArray *New() { return new vtkDoubleArray; }
+};
+
+class vtkIntArray : public vtkAOSDataArrayTemplate<int>
+{
+  public:
+    static vtkIntArray *New() { return new vtkIntArray; }
+};
+
+class vtkIdTypeArray : public vtkAOSDataArrayTemplate<vtkIdType>
+{
+  public:
+    static vtkIdTypeArray *New() { return new vtkIdTypeArray; }
+};
+
+class vtkUnsignedCharArray : public vtkAOSDataArrayTemplate<unsigned char>
+{
+  public:
+    static vtkUnsignedCharArray *New() { return new vtkUnsignedCharArray; }
+};
+
+class vtkPoints : public vtkObject
+{
+  private:
+    vtkFloatArray *_data;
+
+  public:
+    vtkPoints(){
+        _data = vtkFloatArray::New();
+        _data->SetNumberOfComponents(3);
+    }
+    ~vtkPoints() { _data->Delete(); }
+    static vtkPoints *New() { return new vtkPoints; }
+
+    void SetNumberOfPoints(vtkIdType npoint){
+        _data->SetNumberOfTuples(npoint);
+    }
+    vtkIdType GetNumberOfPoints() const { return _data->GetNumberOfTuples(); }
+    void *GetVoidPointer(vtkIdType index){
+        return _data->GetVoidPointer(index);
+    }
+    vtkDataArray *GetData() { return _data; }
+};
+
+class vtkCellArray : public vtkObject
+{
+  private:
+    vtkIdType _ncell;
+    vtkIdTypeArray *_connectivity;
+
+  public:
+    vtkCellArray() : _ncell(0), _connectivity(NULL) {}
+    ~vtkCellArray(){
+        if(_connectivity){
+            _connectivity->Delete();
+        }
+    }
+    static vtkCellArray *New() { return new vtkCellArray; }
+
+    void SetCells(vtkIdType ncell, vtkIdTypeArray *connectivity){
+        connectivity->Register(this);
+        if(_connectivity){
+            _connectivity->Delete();
+        }
+        _ncell = ncell;
+        _connectivity = connectivity;
+    }
+    vtkIdType GetNumberOfCells() const { return _ncell; }
+};
+
+class vtkDataSet : public vtkObject
+{
+  public:
+    virtual vtkIdType GetNumberOfPoints() = 0;
+    virtual vtkIdType GetNumberOfCells() = 0;
+};
+
+class vtkPointSet : public vtkDataSet
+{
+  private:
+    vtkPoints *_points;
+
+  public:
+    vtkPointSet() : _points(NULL) {}
+    ~vtkPointSet(){
+        if(_points){
+            _points->Delete();
+        }
+    }
+
+    void SetPoints(vtkPoints *points){
+        points->Register(this);
+        if(_points){
+            _points->Delete();
+        }
+        _points = points;
+    }
+    vtkPoints *GetPoints() { return _points; }
+    vtkIdType GetNumberOfPoints(){
+        return _points ? _points->GetNumberOfPoints() : 0;
+    }
+};
+
+class vtkUnstructuredGrid : public vtkPointSet
+{
+  private:
+    vtkUnsignedCharArray *_types;
+    vtkIdTypeArray *_locations;
+    vtkCellArray *_cells;
+    // polyhedron faces
+    vtkIdTypeArray *_face_locations;
+    vtkIdTypeArray *_faces;
+
+  public:
+    vtkUnstructuredGrid() : _types(NULL), _locations(NULL), _cells(NULL),
+                            _face_locations(NULL), _faces(NULL) {}
+    ~vtkUnstructuredGrid() { release(); }
+    static vtkUnstructuredGrid *New() { return new vtkUnstructuredGrid; }
+
+    void SetCells(vtkUnsignedCharArray *types, vtkIdTypeArray *locations,
+                  vtkCellArray *cells){
+        types->Register(this);
+        locations->Register(this);
+        cells->Register(this);
+        release();
+        _types = types;
+        _locations = locations;
+        _cells = cells;
+    }
+    void SetCells(vtkUnsignedCharArray *types, vtkIdTypeArray *locations,
+                  vtkCellArray *cells, vtkIdTypeArray *face_locations,
+                  vtkIdTypeArray *faces){
+        face_locations->Register(this);
+        faces->Register(this);
+        SetCells(types, locations, cells);
+        _face_locations = face_locations;
+        _faces = faces;
+    }
+    vtkIdType GetNumberOfCells(){
+        return _cells ? _cells->GetNumberOfCells() : 0;
+    }
+
+  private:
+    void release(){
+        if(_cells){
+            _types->Delete();
+            _locations->Delete();
+            _cells->Delete();
+        }
+        if(_faces){
+            _face_locations->Delete();
+            _faces->Delete();
+        }
+        _face_locations = NULL;
+        _faces = NULL;
+    }
+};
+
+class vtkRectilinearGrid : public vtkDataSet
+{
+  private:
+    int _dims[3];
+    vtkDataArray *_coordinates[3];
+
+  public:
+    vtkRectilinearGrid(){
+        for(unsigned int i = 0; i < 3; i++){
+            _dims[i] = 0;
+            _coordinates[i] = NULL;
+        }
+    }
+    ~vtkRectilinearGrid(){
+        for(unsigned int i = 0; i < 3; i++){
+            set_coordinates(i, NULL);
+        }
+    }
+    static vtkRectilinearGrid *New() { return new vtkRectilinearGrid; }
+
+    void SetDimensions(const int *dims){
+        for(unsigned int i = 0; i < 3; i++){
+            _dims[i] = dims[i];
+        }
+    }
+    void SetXCoordinates(vtkDataArray *x) { set_coordinates(0, x); }
+    void SetYCoordinates(vtkDataArray *y) { set_coordinates(1, y); }
+    void SetZCoordinates(vtkDataArray *z) { set_coordinates(2, z); }
+    vtkIdType GetNumberOfPoints(){
+        return (vtkIdType)_dims[0]*_dims[1]*_dims[2];
+    }
+    vtkIdType GetNumberOfCells(){
+        vtkIdType ncell = 1;
+        for(unsigned int i = 0; i < 3; i++){
+            if(_dims[i] > 1){
+                ncell *= _dims[i] - 1;
+            }
+        }
+        return ncell;
+    }
+
+  private:
+    void set_coordinates(unsigned int i, vtkDataArray *coordinates){
+        if(coordinates){
+            coordinates->Register(this);
+        }
+        if(_coordinates[i]){
+            _coordinates[i]->Delete();
+        }
+        _coordinates[i] = coordinates;
+    }
+};
+
+#endif
@@ -0,0 +1,144 @@
+/*****************************************************************************
+*
+* Copyright (c) 2000 - 2013, Lawrence Livermore National Security, LLC
+* Produced at the Lawrence Livermore National Laboratory
+* LLNL-CODE-442911
+* All rights reserved.
+*
+* This file is  part of VisIt. For  details, see https://visit.llnl.gov/.  The
+* full copyright notice is contained in the file COPYRIGHT located at the root
+* of the VisIt distribution or at http://www.llnl.gov/visit/copyright.html.
+*
+* Redistribution  and  use  in  source  and  binary  forms,  with  or  without
+* modification, are permitted provided that the following conditions are met:
+*
+*  - Redistributions of  source code must  retain the above  copyright notice,
+*    this list of conditions and the disclaimer below.
+*  - Redistributions in binary form must reproduce the above copyright notice,
+*    this  list of  conditions  and  the  disclaimer (as noted below)  in  the
+*    documentation and/or other materials provided with the distribution.
+*  - Neither the name of  the LLNS/LLNL nor the names of  its contributors may
+*    be used to endorse or promote products derived from this software without
+*    specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT  HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR  IMPLIED WARRANTIES, INCLUDING,  BUT NOT  LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND  FITNESS FOR A PARTICULAR  PURPOSE
+* ARE  DISCLAIMED. IN  NO EVENT  SHALL LAWRENCE  LIVERMORE NATIONAL  SECURITY,
+* LLC, THE  U.S.  DEPARTMENT OF  ENERGY  OR  CONTRIBUTORS BE  LIABLE  FOR  ANY
+* DIRECT,  INDIRECT,   INCIDENTAL,   SPECIAL,   EXEMPLARY,  OR   CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT  LIMITED TO, PROCUREMENT OF  SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF  USE, DATA, OR PROFITS; OR  BUSINESS INTERRUPTION) HOWEVER
+* CAUSED  AND  ON  ANY  THEORY  OF  LIABILITY,  WHETHER  IN  CONTRACT,  STRICT
+* LIABILITY, OR TORT  (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY  WAY
+* OUT OF THE  USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+* DAMAGE.
+*
+*****************************************************************************/
+
+
+// ************************************************************************* //
+//                                ByteSwap.h                                 //
+// ************************************************************************* //
+
+#ifndef BYTE_SWAP_H
+#define BYTE_SWAP_H
+
+#include <cstring>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSSE3__)
+#include <tmmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+
+// ****************************************************************************
+//  Class: ByteSwap
+//
+//  Purpose:
+//      Converts arrays of 4 and 8 byte values between little and big endian
+//      byte order, so that snapshots written on a machine with a different
+//      byte order can be read.
+//
+//  Programmer: Bert Vandenbroucke
+//  Creation:   Sat Oct 17 19:27:45 CEST 2026
+//
+//  The arrays are swapped in place, right after they were copied into their
+//  destination buffer. When the compiler targets AVX2, SSSE3 or NEON, the
+//  4 byte values are swapped 8 or 4 at a time with a byte shuffle, so that
+//  a swapped snapshot is read at (almost) memory speed. Otherwise, we use a
+//  plain loop of shifts and masks, which most compilers vectorize
+//  themselves at higher optimization levels.
+//
+// ****************************************************************************
+
+class ByteSwap
+{
+  public:
+    // true if this machine stores values in big endian byte order
+    static bool is_big_endian(){
+        const unsigned int one = 1;
+        return !*reinterpret_cast<const unsigned char*>(&one);
+    }
+
+    // swap the byte order of a single 4 byte value
+    static unsigned int swap(unsigned int v){
+        return (v >> 24) | ((v >> 8) & 0xff00u) | ((v << 8) & 0xff0000u) |
+               (v << 24);
+    }
+
+    // swap the byte order of n consecutive 4 byte values (e.g. floats)
+    static void swap4(void *data, unsigned long long n){
+        unsigned char *bytes = reinterpret_cast<unsigned char*>(data);
+        unsigned long long i = 0;
+#if defined(__AVX2__)
+        const __m256i mask = _mm256_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10,
+                                              9, 8, 15, 14, 13, 12, 3, 2, 1,
+                                              0, 7, 6, 5, 4, 11, 10, 9, 8, 15,
+                                              14, 13, 12);
+        for(; i + 8 <= n; i += 8){
+            __m256i *p = reinterpret_cast<__m256i*>(bytes + 4*i);
+            _mm256_storeu_si256(p, _mm256_shuffle_epi8(_mm256_loadu_si256(p),
+                                                       mask));
+        }
+#elif defined(__SSSE3__)
+        const __m128i mask = _mm_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9,
+                                           8, 15, 14, 13, 12);
+        for(; i + 4 <= n; i += 4){
+            __m128i *p = reinterpret_cast<__m128i*>(bytes + 4*i);
+            _mm_storeu_si128(p, _mm_shuffle_epi8(_mm_loadu_si128(p), mask));
+        }
+#elif defined(__ARM_NEON)
+        for(; i + 4 <= n; i += 4){
+            uint8_t *p = bytes + 4*i;
+            vst1q_u8(p, vrev32q_u8(vld1q_u8(p)));
+        }
+#endif
+        // the remainder (or everything, if there are no vector instructions)
+        for(; i < n; i++){
+            unsigned int v;
+            memcpy(&v, bytes + 4*i, 4);
+            v = swap(v);
+            memcpy(bytes + 4*i, &v, 4);
+        }
+    }
+
+    // swap the byte order of n consecutive 8 byte values (e.g. doubles)
+    static void swap8(void *data, unsigned long long n){
+        unsigned char *bytes = reinterpret_cast<unsigned char*>(data);
+        for(unsigned long long i = 0; i < n; i++){
+            unsigned char *p = bytes + 8*i;
+            for(unsigned int j = 0; j < 4; j++){
+                unsigned char b = p[j];
+                p[j] = p[7-j];
+                p[7-j] = b;
+            }
+        }
+    }
+};
+
+
+#endif
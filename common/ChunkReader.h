@@ -0,0 +1,476 @@
+/*****************************************************************************
+*
+* Copyright (c) 2000 - 2013, Lawrence Livermore National Security, LLC
+* Produced at the Lawrence Livermore National Laboratory
+* LLNL-CODE-442911
+* All rights reserved.
+*
+* This file is  part of VisIt. For  details, see https://visit.llnl.gov/.  The
+* full copyright notice is contained in the file COPYRIGHT located at the root
+* of the VisIt distribution or at http://www.llnl.gov/visit/copyright.html.
+*
+* Redistribution  and  use  in  source  and  binary  forms,  with  or  without
+* modification, are permitted provided that the following conditions are met:
+*
+*  - Redistributions of  source code must  retain the above  copyright notice,
+*    this list of conditions and the disclaimer below.
+*  - Redistributions in binary form must reproduce the above copyright notice,
+*    this  list of  conditions  and  the  disclaimer (as noted below)  in  the
+*    documentation and/or other materials provided with the distribution.
+*  - Neither the name of  the LLNS/LLNL nor the names of  its contributors may
+*    be used to endorse or promote products derived from this software without
+*    specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT  HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR  IMPLIED WARRANTIES, INCLUDING,  BUT NOT  LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND  FITNESS FOR A PARTICULAR  PURPOSE
+* ARE  DISCLAIMED. IN  NO EVENT  SHALL LAWRENCE  LIVERMORE NATIONAL  SECURITY,
+* LLC, THE  U.S.  DEPARTMENT OF  ENERGY  OR  CONTRIBUTORS BE  LIABLE  FOR  ANY
+* DIRECT,  INDIRECT,   INCIDENTAL,   SPECIAL,   EXEMPLARY,  OR   CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT  LIMITED TO, PROCUREMENT OF  SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF  USE, DATA, OR PROFITS; OR  BUSINESS INTERRUPTION) HOWEVER
+* CAUSED  AND  ON  ANY  THEORY  OF  LIABILITY,  WHETHER  IN  CONTRACT,  STRICT
+* LIABILITY, OR TORT  (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY  WAY
+* OUT OF THE  USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+* DAMAGE.
+*
+*****************************************************************************/
+
+
+
+// ************************************************************************* //
+//                               ChunkReader.h                               //
+// ************************************************************************* //
+
+#ifndef CHUNK_READER_H
+#define CHUNK_READER_H
+
+#include <hdf5.h>
+#include <zlib.h>
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+
+// ****************************************************************************
+//  Class: ChunkReader
+//
+//  Purpose:
+//      Reads a range of rows from a chunked, compressed HDF5 dataset by
+//      decompressing its chunks on multiple threads.
+//
+//  Programmer: Bert Vandenbroucke
+//  Creation:   Sat Oct 17 23:58:12 CEST 2026
+//
+//  HDF5 runs the filter pipeline of a dataset on the calling thread, which
+//  limits the read speed of compressed datasets to the speed of zlib on a
+//  single core. Instead, we read the raw (compressed) chunks with
+//  H5Dread_chunk in batches, and undo the filters of the chunks of a batch
+//  in parallel (with OpenMP). Every thread converts the rows and columns we
+//  need from the decompressed chunk straight into the output buffer.
+//  HDF5 itself is only called from the calling thread, since most HDF5
+//  libraries are not thread safe.
+//  Only the filters that are used for lossless compression are supported:
+//  deflate (gzip), shuffle and the Fletcher32 checksum (which is not
+//  verified). The file type has to be a native floating point or integer
+//  type, and the memory type H5T_NATIVE_FLOAT or H5T_NATIVE_DOUBLE.
+//  read() returns false for other datasets (including uncompressed ones,
+//  for which HDF5 is as fast), or if anything goes wrong, in which case the
+//  caller should read the data with H5Dread.
+//
+//  Modifications:
+//    Bert Vandenbroucke, Sun Oct 18 06:44:52 CEST 2026
+//    Keep the decompressed chunks of the last batch, so that a range that
+//    is read in tiles (with the same ChunkReader) decompresses every chunk
+//    only once, even if it is larger than a tile. If the end of the range
+//    is passed on to the constructor, a batch also contains the chunks of
+//    the next tiles, so that a tile within a single chunk still decompresses
+//    on multiple threads. Without OpenMP, HDF5 is faster and read() always
+//    returns false.
+//
+// ****************************************************************************
+
+class ChunkReader
+{
+  private:
+    enum Type{
+        FLOAT = 0,
+        DOUBLE,
+        INT,
+        UINT,
+        LLONG,
+        ULLONG,
+        UNSUPPORTED
+    };
+
+    // a chunk, as stored in the file and after undoing the filters
+    struct Chunk{
+        hsize_t _offset[2];
+        uint32_t _filter_mask;
+        std::vector<char> _data;
+        std::vector<char> _decoded;
+    };
+
+    hid_t _dataset;
+    int _rank;
+    hsize_t _dims[2];
+    hsize_t _chunk[2];
+    Type _filetype;
+    size_t _typesize;
+    // the filters of the pipeline, in the order they are applied on writing
+    std::vector<H5Z_filter_t> _filters;
+    bool _compressed;
+    // the reads continue up to this row
+    unsigned long long _end;
+    // the decompressed chunks of the last batch
+    std::vector<Chunk> _cache;
+
+    static Type get_type(hid_t type){
+        const hid_t types[UNSUPPORTED] = {H5T_NATIVE_FLOAT, H5T_NATIVE_DOUBLE,
+                                          H5T_NATIVE_INT, H5T_NATIVE_UINT,
+                                          H5T_NATIVE_LLONG, H5T_NATIVE_ULLONG};
+        for(int i = 0; i < UNSUPPORTED; i++){
+            if(H5Tequal(type, types[i]) > 0){
+                return (Type)i;
+            }
+        }
+        return UNSUPPORTED;
+    }
+
+    // undo the filters of a chunk; the result ends up in one of the two
+    // buffers, which is returned (or NULL if a filter fails)
+    const char *decode(const Chunk &chunk, std::vector<char> &buffer1,
+                       std::vector<char> &buffer2) const{
+        const char *data = &chunk._data[0];
+        size_t size = chunk._data.size();
+        size_t chunksize = _chunk[0]*_chunk[1]*_typesize;
+        std::vector<char> *out = &buffer1;
+        for(int i = _filters.size()-1; i >= 0; i--){
+            if(chunk._filter_mask & (1 << i)){
+                // this filter was not applied to this chunk
+                continue;
+            }
+            if(_filters[i] == H5Z_FILTER_FLETCHER32){
+                if(size < 4){
+                    return NULL;
+                }
+                size -= 4;
+                continue;
+            }
+            // the checksum is the only filter that could make the data
+            // larger than a chunk
+            out->resize(std::max(chunksize + 4, size));
+            if(_filters[i] == H5Z_FILTER_DEFLATE){
+                uLongf outsize = out->size();
+                if(uncompress(reinterpret_cast<Bytef*>(&(*out)[0]), &outsize,
+                              reinterpret_cast<const Bytef*>(data),
+                              size) != Z_OK){
+                    return NULL;
+                }
+                size = outsize;
+            } else {
+                // shuffle: byte j of element i is stored at j*n+i
+                size_t n = size/_typesize;
+                for(size_t j = 0; j < _typesize; j++){
+                    const char *in = data + j*n;
+                    for(size_t k = 0; k < n; k++){
+                        (*out)[k*_typesize+j] = in[k];
+                    }
+                }
+                for(size_t k = n*_typesize; k < size; k++){
+                    (*out)[k] = data[k];
+                }
+            }
+            data = &(*out)[0];
+            out = (out == &buffer1) ? &buffer2 : &buffer1;
+        }
+        if(size != chunksize){
+            return NULL;
+        }
+        return data;
+    }
+
+    // copy rows first, first+stride... (count rows) and columns
+    // [column, column+ncolumn[ that are in the given decompressed chunk to
+    // the output buffer
+    template<typename IN, typename OUT>
+    void copy(const Chunk &chunk, const IN *in, unsigned long long first,
+              unsigned long long count, unsigned int stride,
+              unsigned int column, unsigned int ncolumn, OUT *out) const{
+        unsigned long long rowbegin = chunk._offset[0];
+        unsigned long long rowend = std::min(rowbegin + _chunk[0],
+                                             (unsigned long long)_dims[0]);
+        unsigned int colbegin = std::max((unsigned int)chunk._offset[1],
+                                         column);
+        unsigned int colend = std::min(chunk._offset[1] + _chunk[1],
+                                       (hsize_t)(column + ncolumn));
+        unsigned long long i = 0;
+        if(rowbegin > first){
+            i = (rowbegin - first + stride - 1)/stride;
+        }
+        for(; i < count && first + i*stride < rowend; i++){
+            const IN *row = in + (first + i*stride - rowbegin)*_chunk[1];
+            for(unsigned int j = colbegin; j < colend; j++){
+                out[i*ncolumn+j-column] = row[j-chunk._offset[1]];
+            }
+        }
+    }
+
+    template<typename OUT>
+    void copy(const Chunk &chunk, const char *in, unsigned long long first,
+              unsigned long long count, unsigned int stride,
+              unsigned int column, unsigned int ncolumn, OUT *out) const{
+        switch(_filetype){
+        case FLOAT:
+            copy(chunk, reinterpret_cast<const float*>(in), first, count,
+                 stride, column, ncolumn, out);
+            break;
+        case DOUBLE:
+            copy(chunk, reinterpret_cast<const double*>(in), first, count,
+                 stride, column, ncolumn, out);
+            break;
+        case INT:
+            copy(chunk, reinterpret_cast<const int*>(in), first, count,
+                 stride, column, ncolumn, out);
+            break;
+        case UINT:
+            copy(chunk, reinterpret_cast<const unsigned int*>(in), first,
+                 count, stride, column, ncolumn, out);
+            break;
+        case LLONG:
+            copy(chunk, reinterpret_cast<const long long*>(in), first, count,
+                 stride, column, ncolumn, out);
+            break;
+        default:
+            copy(chunk, reinterpret_cast<const unsigned long long*>(in),
+                 first, count, stride, column, ncolumn, out);
+            break;
+        }
+    }
+
+    // true if one of the rows first, first+stride... is in the chunks that
+    // start at the given row
+    bool has_rows(unsigned long long row, unsigned long long first,
+                  unsigned int stride) const{
+        unsigned long long i = 0;
+        if(row > first){
+            i = (row - first + stride - 1)/stride;
+        }
+        return first + i*stride < row + _chunk[0];
+    }
+
+    // the decompressed chunk at the given offset, or NULL if it is not in
+    // the last batch
+    const Chunk *find(hsize_t row, hsize_t col) const{
+        for(unsigned int i = 0; i < _cache.size(); i++){
+            if(_cache[i]._offset[0] == row && _cache[i]._offset[1] == col){
+                return &_cache[i];
+            }
+        }
+        return NULL;
+    }
+
+    // read and decompress a new batch of about 64 MB of chunks with columns
+    // [column, column+ncolumn[, starting at the given row and ending at the
+    // latest at row end, on nthread threads
+    bool decode_batch(unsigned long long row, unsigned long long end,
+                      unsigned long long first, unsigned int stride,
+                      unsigned int column, unsigned int ncolumn,
+                      int nthread){
+#if H5_VERSION_GE(1, 10, 3)
+        const size_t batchsize = 1 << 26;
+        size_t chunksize = _chunk[0]*_chunk[1]*_typesize;
+        _cache.clear();
+        size_t size = 0;
+        for(; row < end && (_cache.empty() || size < batchsize);
+            row += _chunk[0]){
+            // skip chunks that contain none of the rows (for large strides)
+            if(!has_rows(row, first, stride)){
+                continue;
+            }
+            for(hsize_t col = column - column%_chunk[1];
+                col < column + ncolumn; col += _chunk[1]){
+                _cache.push_back(Chunk());
+                Chunk &chunk = _cache.back();
+                chunk._offset[0] = row;
+                chunk._offset[1] = col;
+                hsize_t nbyte = 0;
+                if(H5Dget_chunk_storage_size(_dataset, chunk._offset,
+                                             &nbyte) < 0 || !nbyte){
+                    _cache.clear();
+                    return false;
+                }
+                chunk._data.resize(nbyte);
+                if(H5Dread_chunk(_dataset, H5P_DEFAULT, chunk._offset,
+                                 &chunk._filter_mask, &chunk._data[0]) < 0){
+                    _cache.clear();
+                    return false;
+                }
+                size += chunksize;
+            }
+        }
+
+        int nfail = 0;
+        int nchunk = _cache.size();
+#pragma omp parallel num_threads(nthread) reduction(+:nfail)
+        {
+            std::vector<char> buffer1, buffer2;
+#pragma omp for schedule(dynamic)
+            for(int i = 0; i < nchunk; i++){
+                Chunk &chunk = _cache[i];
+                const char *in = decode(chunk, buffer1, buffer2);
+                if(!in){
+                    nfail++;
+                    continue;
+                }
+                if(!buffer1.empty() && in == &buffer1[0]){
+                    chunk._decoded.swap(buffer1);
+                } else if(!buffer2.empty() && in == &buffer2[0]){
+                    chunk._decoded.swap(buffer2);
+                } else {
+                    chunk._decoded.assign(in, in + chunksize);
+                }
+                std::vector<char>().swap(chunk._data);
+            }
+        }
+        if(nfail){
+            _cache.clear();
+        }
+        return nfail == 0;
+#else
+        return false;
+#endif
+    }
+
+    // copy the rows and columns we need from the given decompressed chunks
+    // to the output buffer, on nthread threads
+    void copy_chunks(const std::vector<const Chunk*> &chunks, bool dbl,
+                     unsigned long long first, unsigned long long count,
+                     unsigned int stride, unsigned int column,
+                     unsigned int ncolumn, void *data, int nthread) const{
+        int nchunk = chunks.size();
+#pragma omp parallel for num_threads(nthread) schedule(dynamic)
+        for(int i = 0; i < nchunk; i++){
+            const Chunk &chunk = *chunks[i];
+            if(dbl){
+                copy(chunk, &chunk._decoded[0], first, count, stride, column,
+                     ncolumn, reinterpret_cast<double*>(data));
+            } else {
+                copy(chunk, &chunk._decoded[0], first, count, stride, column,
+                     ncolumn, reinterpret_cast<float*>(data));
+            }
+        }
+    }
+
+  public:
+    // end is the row up to which the dataset will be read with this
+    // ChunkReader (0 if only the rows passed on to read() are needed)
+    ChunkReader(hid_t dataset, unsigned long long end = 0)
+        : _dataset(dataset), _rank(0), _filetype(UNSUPPORTED), _typesize(0),
+          _compressed(false), _end(end){
+        _dims[0] = _dims[1] = 1;
+        _chunk[0] = _chunk[1] = 1;
+        hid_t filespace = H5Dget_space(dataset);
+        _rank = H5Sget_simple_extent_dims(filespace, _dims, NULL);
+        H5Sclose(filespace);
+        hid_t plist = H5Dget_create_plist(dataset);
+        if(_rank < 1 || _rank > 2 || H5Pget_layout(plist) != H5D_CHUNKED){
+            H5Pclose(plist);
+            return;
+        }
+        H5Pget_chunk(plist, _rank, _chunk);
+        int nfilter = H5Pget_nfilters(plist);
+        for(int i = 0; i < nfilter; i++){
+            unsigned int flags;
+            size_t nvalue = 0;
+            H5Z_filter_t filter = H5Pget_filter2(plist, i, &flags, &nvalue,
+                                                 NULL, 0, NULL, NULL);
+            if(filter != H5Z_FILTER_DEFLATE && filter != H5Z_FILTER_SHUFFLE &&
+               filter != H5Z_FILTER_FLETCHER32){
+                // e.g. scale-offset or n-bit (lossy) compression
+                H5Pclose(plist);
+                return;
+            }
+            if(filter == H5Z_FILTER_DEFLATE){
+                _compressed = true;
+            }
+            _filters.push_back(filter);
+        }
+        H5Pclose(plist);
+        hid_t type = H5Dget_type(dataset);
+        _filetype = get_type(type);
+        _typesize = H5Tget_size(type);
+        H5Tclose(type);
+    }
+
+    // true if read() can be used for this dataset and memory type
+    bool supported(hid_t memtype) const{
+#if H5_VERSION_GE(1, 10, 3) && defined(_OPENMP)
+        return _compressed && _filetype != UNSUPPORTED &&
+               (H5Tequal(memtype, H5T_NATIVE_FLOAT) > 0 ||
+                H5Tequal(memtype, H5T_NATIVE_DOUBLE) > 0);
+#else
+        return false;
+#endif
+    }
+
+    // read rows first, first+stride... (count rows) and columns
+    // [column, column+ncolumn[ (all columns if ncolumn is 0) into data,
+    // converted to the given memory type, using nthread threads
+    bool read(hid_t memtype, unsigned long long first,
+              unsigned long long count, unsigned int stride,
+              unsigned int column, unsigned int ncolumn, void *data,
+              int nthread){
+        if(!supported(memtype)){
+            return false;
+        }
+        if(!count){
+            return true;
+        }
+        if(ncolumn == 0){
+            column = 0;
+            ncolumn = _dims[1];
+        }
+        bool dbl = (H5Tequal(memtype, H5T_NATIVE_DOUBLE) > 0);
+        unsigned long long last = first + (count-1)*stride;
+        // the next batch may also contain the chunks of the next reads
+        unsigned long long end = std::min(std::max(last + 1, _end),
+                                          (unsigned long long)_dims[0]);
+        // chunks of the last batch that still have to be copied
+        std::vector<const Chunk*> chunks;
+        for(hsize_t row = first - first%_chunk[0]; row <= last;
+            row += _chunk[0]){
+            if(!has_rows(row, first, stride)){
+                continue;
+            }
+            hsize_t colbegin = column - column%_chunk[1];
+            bool cached = true;
+            for(hsize_t col = colbegin; col < column + ncolumn;
+                col += _chunk[1]){
+                cached &= (find(row, col) != NULL);
+            }
+            if(!cached){
+                // copy what we need from the last batch before we replace
+                // it
+                copy_chunks(chunks, dbl, first, count, stride, column,
+                            ncolumn, data, nthread);
+                chunks.clear();
+                if(!decode_batch(row, end, first, stride, column, ncolumn,
+                                 nthread)){
+                    return false;
+                }
+            }
+            for(hsize_t col = colbegin; col < column + ncolumn;
+                col += _chunk[1]){
+                chunks.push_back(find(row, col));
+            }
+        }
+        copy_chunks(chunks, dbl, first, count, stride, column, ncolumn, data,
+                    nthread);
+        return true;
+    }
+};
+
+
+#endif
@@ -0,0 +1,351 @@
+/*****************************************************************************
+*
+* Copyright (c) 2000 - 2013, Lawrence Livermore National Security, LLC
+* Produced at the Lawrence Livermore National Laboratory
+* LLNL-CODE-442911
+* All rights reserved.
+*
+* This file is  part of VisIt. For  details, see https://visit.llnl.gov/.  The
+* full copyright notice is contained in the file COPYRIGHT located at the root
+* of the VisIt distribution or at http://www.llnl.gov/visit/copyright.html.
+*
+* Redistribution  and  use  in  source  and  binary  forms,  with  or  without
+* modification, are permitted provided that the following conditions are met:
+*
+*  - Redistributions of  source code must  retain the above  copyright notice,
+*    this list of conditions and the disclaimer below.
+*  - Redistributions in binary form must reproduce the above copyright notice,
+*    this  list of  conditions  and  the  disclaimer (as noted below)  in  the
+*    documentation and/or other materials provided with the distribution.
+*  - Neither the name of  the LLNS/LLNL nor the names of  its contributors may
+*    be used to endorse or promote products derived from this software without
+*    specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT  HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR  IMPLIED WARRANTIES, INCLUDING,  BUT NOT  LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND  FITNESS FOR A PARTICULAR  PURPOSE
+* ARE  DISCLAIMED. IN  NO EVENT  SHALL LAWRENCE  LIVERMORE NATIONAL  SECURITY,
+* LLC, THE  U.S.  DEPARTMENT OF  ENERGY  OR  CONTRIBUTORS BE  LIABLE  FOR  ANY
+* DIRECT,  INDIRECT,   INCIDENTAL,   SPECIAL,   EXEMPLARY,  OR   CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT  LIMITED TO, PROCUREMENT OF  SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF  USE, DATA, OR PROFITS; OR  BUSINESS INTERRUPTION) HOWEVER
+* CAUSED  AND  ON  ANY  THEORY  OF  LIABILITY,  WHETHER  IN  CONTRACT,  STRICT
+* LIABILITY, OR TORT  (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY  WAY
+* OUT OF THE  USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+* DAMAGE.
+*
+*****************************************************************************/
+
+
+// ************************************************************************* //
+//                              ColumnReader.h                               //
+// ************************************************************************* //
+
+#ifndef COLUMN_READER_H
+#define COLUMN_READER_H
+
+#include <hdf5.h>
+
+#include <algorithm>
+
+
+// ****************************************************************************
+//  Class: ColumnReader
+//
+//  Purpose:
+//      Reads the vector quantities of particles (coordinates, velocities,
+//      rows of tensors...) from HDF5 datasets into the rows of 3 floats that
+//      VTK expects, independent of the way they are stored in the file.
+//
+//  Programmer: Bert Vandenbroucke
+//  Creation:   Sat Oct 17 22:04:36 CEST 2026
+//
+//  The components of a vector can be stored as separate 1D datasets
+//  (structure of arrays, e.g. x, y and z) or as consecutive columns of a
+//  single 2D dataset (array of structures, e.g. an N x 3 dataset or a row
+//  of an N x 9 tensor), as 2 (2D simulations) or 3 components, in single or
+//  double precision. For every combination, the data is read in its native
+//  type and converted and interleaved in a single pass by a kernel that is
+//  specialized at compile time on the type, the number of components and
+//  the layout, so that all loops have constant bounds and strides. 2D
+//  vectors are padded with a zero third component.
+//  3 consecutive columns are read straight into the output buffer, since
+//  HDF5 converts them to floats on the fly.
+//  The actual reading is done by the plugin, through a Reader functor with
+//      herr_t operator()(hid_t dataset, hid_t memtype, void *data,
+//                        unsigned int column, unsigned int ncolumn)
+//  that reads columns [column, column+ncolumn[ (all columns if ncolumn is
+//  0) of the rows of the dataset the plugin is interested in, so that the
+//  ColumnReader does not need to know about domains or subsampling.
+//
+//  Modifications:
+//    Bert Vandenbroucke, Sun Oct 18 00:36:47 CEST 2026
+//    Added read_tiles, which reads components that are stored in separate
+//    datasets in tiles of rows that fit in the cache, and interleaves and
+//    converts every tile in a single multithreaded pass. This needs a
+//    Reader that splits the rows into tiles, with
+//        unsigned int get_ntile()
+//        unsigned long long get_tile_size(unsigned int itile)
+//        herr_t operator()(unsigned int itile, hid_t dataset, hid_t memtype,
+//                          void *data)
+//    where the tile size is the number of rows in the tile. Only one tile
+//    of every component is kept in memory, instead of a full column.
+//
+//    Bert Vandenbroucke, Sun Oct 18 04:07:45 CEST 2026
+//    Added read_vector_tile(s), which read vectors from the columns of a
+//    single dataset tile by tile, with a tiled Reader whose tile operator
+//    also takes the column and ncolumn arguments. 2 component vectors then
+//    only need a tile sized buffer, so that the extra memory no longer
+//    grows with the number of particles.
+//
+// ****************************************************************************
+
+class ColumnReader
+{
+  private:
+    static hid_t get_memtype(const float*){
+        return H5T_NATIVE_FLOAT;
+    }
+
+    static hid_t get_memtype(const double*){
+        return H5T_NATIVE_DOUBLE;
+    }
+
+    // true if the dataset contains double precision values, which we then
+    // read as doubles (everything else is read as floats)
+    static bool is_double(hid_t dataset){
+        hid_t type = H5Dget_type(dataset);
+        bool dbl = (H5Tget_class(type) == H5T_FLOAT &&
+                    H5Tget_size(type) > sizeof(float));
+        H5Tclose(type);
+        return dbl;
+    }
+
+    // Reader for the rows in a single tile of a tiled Reader
+    template<class Reader>
+    class Tile{
+    private:
+        Reader &_reader;
+        unsigned int _itile;
+
+    public:
+        Tile(Reader &reader, unsigned int itile)
+            : _reader(reader), _itile(itile) {}
+
+        herr_t operator()(hid_t dataset, hid_t memtype, void *data,
+                          unsigned int column, unsigned int ncolumn){
+            return _reader(_itile, dataset, memtype, data, column, ncolumn);
+        }
+    };
+
+  public:
+    // number of columns of a (1D or 2D) dataset
+    static unsigned int get_ncolumn(hid_t dataset){
+        hid_t filespace = H5Dget_space(dataset);
+        hsize_t dims[2] = {0, 1};
+        H5Sget_simple_extent_dims(filespace, dims, NULL);
+        H5Sclose(filespace);
+        return dims[1];
+    }
+
+    // copy component COMPONENT of n rows of 3 floats from a column
+    template<typename T, unsigned int COMPONENT>
+    static void scatter(const T *column, unsigned long long n, float *out){
+        long long nloop = n;
+#pragma omp parallel for schedule(static)
+        for(long long i = 0; i < nloop; i++){
+            out[3*i+COMPONENT] = column[i];
+        }
+    }
+
+    // copy n rows of NCOMPONENT values that are STRIDE values apart to n
+    // rows of 3 floats (padded with zeros)
+    template<typename T, unsigned int NCOMPONENT, unsigned int STRIDE>
+    static void gather(const T *rows, unsigned long long n, float *out){
+        long long nloop = n;
+#pragma omp parallel for schedule(static)
+        for(long long i = 0; i < nloop; i++){
+            for(unsigned int k = 0; k < NCOMPONENT; k++){
+                out[3*i+k] = rows[STRIDE*i+k];
+            }
+            for(unsigned int k = NCOMPONENT; k < 3; k++){
+                out[3*i+k] = 0.f;
+            }
+        }
+    }
+
+    // interleave the first n values of NCOMPONENT columns into n rows of 3
+    // floats (padded with zeros), in a single pass over the output. The
+    // loop has constant strides, so that the compiler can vectorize it
+    template<typename T, unsigned int NCOMPONENT>
+    static void interleave(T *const *columns, unsigned long long n,
+                           float *out){
+        const T *column0 = columns[0];
+        const T *column1 = columns[1];
+        const T *column2 = columns[NCOMPONENT-1];
+        long long nloop = n;
+#pragma omp parallel for schedule(static)
+        for(long long i = 0; i < nloop; i++){
+            out[3*i] = column0[i];
+            out[3*i+1] = column1[i];
+            out[3*i+2] = (NCOMPONENT == 3) ? (float)column2[i] : 0.f;
+        }
+    }
+
+    // read vectors with NCOMPONENT components that are stored in separate
+    // datasets, tile by tile
+    template<typename T, unsigned int NCOMPONENT, class Reader>
+    static herr_t read_column_tiles(Reader &reader, const hid_t *datasets,
+                                    float *out){
+        unsigned long long tilesize = 0;
+        for(unsigned int i = 0; i < reader.get_ntile(); i++){
+            tilesize = std::max(tilesize, reader.get_tile_size(i));
+        }
+        T *buffer = new T[NCOMPONENT*tilesize];
+        T *columns[NCOMPONENT];
+        for(unsigned int k = 0; k < NCOMPONENT; k++){
+            columns[k] = buffer + k*tilesize;
+        }
+        herr_t status = 0;
+        for(unsigned int i = 0; i < reader.get_ntile() && status >= 0; i++){
+            unsigned long long n = reader.get_tile_size(i);
+            for(unsigned int k = 0; k < NCOMPONENT && status >= 0; k++){
+                status = reader(i, datasets[k], get_memtype(buffer),
+                                columns[k]);
+            }
+            interleave<T, NCOMPONENT>(columns, n, out);
+            out += 3*n;
+        }
+        delete [] buffer;
+        return status;
+    }
+
+    // read n vectors with NCOMPONENT components that are stored in separate
+    // datasets
+    template<typename T, unsigned int NCOMPONENT, class Reader>
+    static herr_t read_columns(Reader &reader, const hid_t *datasets,
+                               unsigned long long n, float *out){
+        T *buffer = new T[n];
+        herr_t status = 0;
+        for(unsigned int k = 0; k < NCOMPONENT && status >= 0; k++){
+            status = reader(datasets[k], get_memtype(buffer), buffer, 0, 0);
+            if(k == 0){
+                scatter<T, 0>(buffer, n, out);
+            } else if(k == 1){
+                scatter<T, 1>(buffer, n, out);
+            } else {
+                scatter<T, 2>(buffer, n, out);
+            }
+        }
+        delete [] buffer;
+        if(NCOMPONENT < 3){
+            long long nloop = n;
+#pragma omp parallel for schedule(static)
+            for(long long i = 0; i < nloop; i++){
+                out[3*i+2] = 0.f;
+            }
+        }
+        return status;
+    }
+
+    // read n vectors with NCOMPONENT components that are stored in the
+    // consecutive columns of a single dataset, starting from the given
+    // column
+    template<typename T, unsigned int NCOMPONENT, class Reader>
+    static herr_t read_rows(Reader &reader, hid_t dataset,
+                            unsigned int column, unsigned long long n,
+                            float *out){
+        if(NCOMPONENT == 3){
+            return reader(dataset, H5T_NATIVE_FLOAT, out, column, 3);
+        }
+        T *buffer = new T[n*NCOMPONENT];
+        herr_t status = reader(dataset, get_memtype(buffer), buffer, column,
+                               NCOMPONENT);
+        gather<T, NCOMPONENT, NCOMPONENT>(buffer, n, out);
+        delete [] buffer;
+        return status;
+    }
+
+    // read n vectors with ncomponent (2 or 3) components into rows of 3
+    // floats. If ndataset > 1, the components are stored in ndataset
+    // separate datasets (and column is ignored); otherwise they are the
+    // columns [column, column+ncomponent[ of the first dataset, or all
+    // columns of the first dataset if ncomponent is 0
+    template<class Reader>
+    static herr_t read_vectors(Reader &reader, const hid_t *datasets,
+                               unsigned int ndataset, unsigned int column,
+                               unsigned int ncomponent, unsigned long long n,
+                               float *out){
+        bool dbl = is_double(datasets[0]);
+        if(!ncomponent){
+            ncomponent = get_ncolumn(datasets[0]);
+        }
+        if(ndataset > 1){
+            if(ndataset == 2){
+                return dbl ? read_columns<double, 2>(reader, datasets, n, out)
+                           : read_columns<float, 2>(reader, datasets, n, out);
+            }
+            return dbl ? read_columns<double, 3>(reader, datasets, n, out)
+                       : read_columns<float, 3>(reader, datasets, n, out);
+        }
+        if(ncomponent == 2){
+            return dbl ? read_rows<double, 2>(reader, datasets[0], column, n,
+                                              out)
+                       : read_rows<float, 2>(reader, datasets[0], column, n,
+                                             out);
+        }
+        return read_rows<float, 3>(reader, datasets[0], column, n, out);
+    }
+
+    // read vectors with ncomponent (2 or 3) components that are stored in
+    // ncomponent separate datasets into rows of 3 floats, in the tiles of
+    // the given Reader
+    template<class Reader>
+    static herr_t read_tiles(Reader &reader, const hid_t *datasets,
+                             unsigned int ncomponent, float *out){
+        bool dbl = is_double(datasets[0]);
+        if(ncomponent == 2){
+            return dbl ? read_column_tiles<double, 2>(reader, datasets, out)
+                       : read_column_tiles<float, 2>(reader, datasets, out);
+        }
+        return dbl ? read_column_tiles<double, 3>(reader, datasets, out)
+                   : read_column_tiles<float, 3>(reader, datasets, out);
+    }
+
+    // read the vectors in tile itile of the given tiled Reader, as
+    // read_vectors does for a single dataset
+    template<class Reader>
+    static herr_t read_vector_tile(Reader &reader, unsigned int itile,
+                                   hid_t dataset, unsigned int column,
+                                   unsigned int ncomponent, float *out){
+        Tile<Reader> tile(reader, itile);
+        return read_vectors(tile, &dataset, 1, column, ncomponent,
+                            reader.get_tile_size(itile), out);
+    }
+
+    // read vectors from the columns [column, column+ncomponent[ (all
+    // columns if ncomponent is 0) of a single dataset, tile by tile. 3
+    // components are converted by HDF5 while they are read into the output
+    // buffer, so they are read in one go
+    template<class Reader>
+    static herr_t read_vector_tiles(Reader &reader, hid_t dataset,
+                                    unsigned int column,
+                                    unsigned int ncomponent, float *out){
+        if(!ncomponent){
+            ncomponent = get_ncolumn(dataset);
+        }
+        if(ncomponent == 3){
+            return reader(dataset, H5T_NATIVE_FLOAT, out, column, 3);
+        }
+        herr_t status = 0;
+        for(unsigned int i = 0; i < reader.get_ntile() && status >= 0; i++){
+            status = read_vector_tile(reader, i, dataset, column, ncomponent,
+                                      out);
+            out += 3*reader.get_tile_size(i);
+        }
+        return status;
+    }
+};
+
+
+#endif
@@ -0,0 +1,352 @@
+/*****************************************************************************
+*
+* Copyright (c) 2000 - 2013, Lawrence Livermore National Security, LLC
+* Produced at the Lawrence Livermore National Laboratory
+* LLNL-CODE-442911
+* All rights reserved.
+*
+* This file is  part of VisIt. For  details, see https://visit.llnl.gov/.  The
+* full copyright notice is contained in the file COPYRIGHT located at the root
+* of the VisIt distribution or at http://www.llnl.gov/visit/copyright.html.
+*
+* Redistribution  and  use  in  source  and  binary  forms,  with  or  without
+* modification, are permitted provided that the following conditions are met:
+*
+*  - Redistributions of  source code must  retain the above  copyright notice,
+*    this list of conditions and the disclaimer below.
+*  - Redistributions in binary form must reproduce the above copyright notice,
+*    this  list of  conditions  and  the  disclaimer (as noted below)  in  the
+*    documentation and/or other materials provided with the distribution.
+*  - Neither the name of  the LLNS/LLNL nor the names of  its contributors may
+*    be used to endorse or promote products derived from this software without
+*    specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT  HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR  IMPLIED WARRANTIES, INCLUDING,  BUT NOT  LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND  FITNESS FOR A PARTICULAR  PURPOSE
+* ARE  DISCLAIMED. IN  NO EVENT  SHALL LAWRENCE  LIVERMORE NATIONAL  SECURITY,
+* LLC, THE  U.S.  DEPARTMENT OF  ENERGY  OR  CONTRIBUTORS BE  LIABLE  FOR  ANY
+* DIRECT,  INDIRECT,   INCIDENTAL,   SPECIAL,   EXEMPLARY,  OR   CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT  LIMITED TO, PROCUREMENT OF  SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF  USE, DATA, OR PROFITS; OR  BUSINESS INTERRUPTION) HOWEVER
+* CAUSED  AND  ON  ANY  THEORY  OF  LIABILITY,  WHETHER  IN  CONTRACT,  STRICT
+* LIABILITY, OR TORT  (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY  WAY
+* OUT OF THE  USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+* DAMAGE.
+*
+*****************************************************************************/
+
+
+// ************************************************************************* //
+//                               DataExtents.h                               //
+// ************************************************************************* //
+
+#ifndef DATA_EXTENTS_H
+#define DATA_EXTENTS_H
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <SidecarFile.h>
+
+
+// ****************************************************************************
+//  Class: DataExtents
+//
+//  Purpose:
+//      Keeps track of the range and a coarse histogram of the values of
+//      every variable on every domain, so that VisIt can skip domains that
+//      do not contain the values it is interested in (e.g. for a threshold
+//      or an isosurface) without reading them.
+//
+//  Programmer: Bert Vandenbroucke
+//  Creation:   Sat Oct 17 16:02:41 CEST 2026
+//
+//  The extents of a domain are computed from the values that are read for
+//  it anyway (in GetVar or GetVectorVar), with a single pass over the data
+//  that the compiler can vectorize and that is multithreaded with OpenMP.
+//  For vectors, the extents and histogram are those of the magnitude, as
+//  VisIt expects. The histogram has NBIN equal bins between the minimum and
+//  maximum of the domain.
+//  The extents only make sense for a given division of the snapshot in
+//  domains, which is described by the number of domains and a short string
+//  set by the reader. Both are stored with the extents in a sidecar file
+//  next to the snapshot (see SidecarFile), so that they only have to be
+//  computed once. Writing the sidecar file merges in the extents that are
+//  already present in it, so that the ranks of a parallel engine can each
+//  contribute the domains they read.
+//
+//  Modifications:
+//    Bert Vandenbroucke, Sun Oct 18 05:02:17 CEST 2026
+//    Added has_all and get_range, so that the readers only return data
+//    extents once all domains are known, without widening the range of the
+//    variable with the (inverted) range of empty domains.
+//
+// ****************************************************************************
+
+class DataExtents
+{
+  public:
+    static const unsigned int NBIN = 16;
+
+    class Extents{
+    public:
+        bool _known;
+        // an empty domain has an empty (inverted) range
+        double _min;
+        double _max;
+        unsigned long long _histogram[NBIN];
+
+        Extents() : _known(false), _min(1.), _max(-1.) {
+            for(unsigned int i = 0; i < NBIN; i++){
+                _histogram[i] = 0;
+            }
+        }
+
+        bool empty() const {
+            return _min > _max;
+        }
+    };
+
+  private:
+    std::string _decomposition;
+    unsigned int _ndomain;
+    std::map< std::string, std::vector<Extents> > _extents;
+    bool _initialized;
+    bool _changed;
+
+    std::vector<Extents> &get_list(const std::string &var){
+        std::vector<Extents> &list = _extents[var];
+        list.resize(_ndomain);
+        return list;
+    }
+
+    // add the extents in the sidecar file that we do not know yet
+    bool merge(SidecarFile &file){
+        std::string decomposition;
+        unsigned int ndomain = 0;
+        unsigned int length = 0;
+        unsigned int nvar = 0;
+        file.read(length);
+        if(!file.good() || length > 1024){
+            return false;
+        }
+        decomposition.resize(length);
+        if(length){
+            file.read(&decomposition[0], length);
+        }
+        file.read(ndomain);
+        file.read(nvar);
+        if(!file.good() || decomposition != _decomposition ||
+           ndomain != _ndomain){
+            return false;
+        }
+        for(unsigned int v = 0; v < nvar && file.good(); v++){
+            std::string var;
+            file.read(length);
+            if(!file.good() || length > 1024){
+                return false;
+            }
+            var.resize(length);
+            if(length){
+                file.read(&var[0], length);
+            }
+            std::vector<Extents> &list = get_list(var);
+            for(unsigned int i = 0; i < ndomain && file.good(); i++){
+                Extents extents;
+                unsigned char known = 0;
+                file.read(known);
+                file.read(extents._min);
+                file.read(extents._max);
+                file.read(extents._histogram, NBIN);
+                extents._known = (known != 0);
+                if(extents._known && !list[i]._known && file.good()){
+                    list[i] = extents;
+                }
+            }
+        }
+        return file.good();
+    }
+
+  public:
+    DataExtents() : _ndomain(0), _initialized(false), _changed(false) {}
+
+    // set the division of the snapshot in domains (removes all extents)
+    void initialize(unsigned int ndomain, const std::string &decomposition){
+        _extents.clear();
+        _ndomain = ndomain;
+        _decomposition = decomposition;
+        _initialized = true;
+        _changed = false;
+    }
+
+    void clear(){
+        _extents.clear();
+        _initialized = false;
+        _changed = false;
+    }
+
+    bool initialized() const {
+        return _initialized;
+    }
+
+    // true if extents were computed that are not yet in the sidecar file
+    bool changed() const {
+        return _changed;
+    }
+
+    unsigned int get_number_of_domains() const {
+        return _ndomain;
+    }
+
+    bool has(const std::string &var, unsigned int domain) const {
+        std::map< std::string, std::vector<Extents> >::const_iterator it =
+            _extents.find(var);
+        return it != _extents.end() && it->second[domain]._known;
+    }
+
+    // true if the extents of the variable are known on every domain
+    bool has_all(const std::string &var) const {
+        for(unsigned int i = 0; i < _ndomain; i++){
+            if(!has(var, i)){
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // only valid if has(var, domain) is true
+    const Extents &get(const std::string &var, unsigned int domain) const {
+        return _extents.find(var)->second[domain];
+    }
+
+    // range of the variable on all non-empty domains (an empty range if all
+    // domains are empty), only valid if has_all(var) is true
+    void get_range(const std::string &var, double &vmin,
+                   double &vmax) const {
+        vmin = 1.;
+        vmax = -1.;
+        for(unsigned int i = 0; i < _ndomain; i++){
+            const Extents &extents = get(var, i);
+            if(extents.empty()){
+                continue;
+            }
+            if(vmin > vmax){
+                vmin = extents._min;
+                vmax = extents._max;
+            } else {
+                vmin = std::min(vmin, extents._min);
+                vmax = std::max(vmax, extents._max);
+            }
+        }
+    }
+
+    // compute the extents of the n values (with ncomp components each) of
+    // the given variable on the given domain
+    void set(const std::string &var, unsigned int domain, const float *data,
+             unsigned long long n, unsigned int ncomp = 1){
+        Extents &extents = get_list(var)[domain];
+        extents = Extents();
+        extents._known = true;
+        _changed = true;
+        if(!n){
+            return;
+        }
+
+        std::vector<float> magnitudes;
+        const float *values = data;
+        long long nloop = n;
+        if(ncomp > 1){
+            magnitudes.resize(n);
+#pragma omp parallel for schedule(static)
+            for(long long i = 0; i < nloop; i++){
+                float norm2 = 0.f;
+                for(unsigned int j = 0; j < ncomp; j++){
+                    norm2 += data[ncomp*i+j]*data[ncomp*i+j];
+                }
+                magnitudes[i] = std::sqrt(norm2);
+            }
+            values = &magnitudes[0];
+        }
+
+        float vmin = values[0];
+        float vmax = values[0];
+#pragma omp parallel for schedule(static) reduction(min:vmin) reduction(max:vmax)
+        for(long long i = 0; i < nloop; i++){
+            vmin = std::min(vmin, values[i]);
+            vmax = std::max(vmax, values[i]);
+        }
+        extents._min = vmin;
+        extents._max = vmax;
+
+        double scale = vmax > vmin ? NBIN/((double)vmax - vmin) : 0.;
+#pragma omp parallel
+        {
+            unsigned long long histogram[NBIN];
+            for(unsigned int b = 0; b < NBIN; b++){
+                histogram[b] = 0;
+            }
+#pragma omp for schedule(static)
+            for(long long i = 0; i < nloop; i++){
+                // NaN values fail both comparisons and are not counted
+                if(values[i] >= vmin && values[i] <= vmax){
+                    unsigned int b = (values[i] - vmin)*scale;
+                    histogram[std::min(b, NBIN-1)]++;
+                }
+            }
+#pragma omp critical
+            for(unsigned int b = 0; b < NBIN; b++){
+                extents._histogram[b] += histogram[b];
+            }
+        }
+    }
+
+    // read the extents from the sidecar file of the given snapshot
+    // returns false if there is no (valid) sidecar file for the current
+    // division in domains
+    bool read(const std::string &snapshot){
+        SidecarFile file(snapshot, ".extents");
+        if(!file.open_read("EXTENTS ", 1)){
+            return false;
+        }
+        return merge(file);
+    }
+
+    // write the extents to the sidecar file of the given snapshot, together
+    // with the extents that are already in that file
+    bool write(const std::string &snapshot){
+        read(snapshot);
+        SidecarFile file(snapshot, ".extents");
+        if(!file.open_write("EXTENTS ", 1)){
+            return false;
+        }
+        unsigned int length = _decomposition.size();
+        unsigned int nvar = _extents.size();
+        file.write(length);
+        file.write(_decomposition.c_str(), length);
+        file.write(_ndomain);
+        file.write(nvar);
+        std::map< std::string, std::vector<Extents> >::const_iterator it;
+        for(it = _extents.begin(); it != _extents.end(); ++it){
+            length = it->first.size();
+            file.write(length);
+            file.write(it->first.c_str(), length);
+            for(unsigned int i = 0; i < _ndomain; i++){
+                const Extents &extents = it->second[i];
+                unsigned char known = extents._known;
+                file.write(known);
+                file.write(extents._min);
+                file.write(extents._max);
+                file.write(extents._histogram, NBIN);
+            }
+        }
+        _changed = !file.commit();
+        return !_changed;
+    }
+};
+
+
+#endif
@@ -0,0 +1,286 @@
+/*****************************************************************************
+*
+* Copyright (c) 2000 - 2013, Lawrence Livermore National Security, LLC
+* Produced at the Lawrence Livermore National Laboratory
+* LLNL-CODE-442911
+* All rights reserved.
+*
+* This file is  part of VisIt. For  details, see https://visit.llnl.gov/.  The
+* full copyright notice is contained in the file COPYRIGHT located at the root
+* of the VisIt distribution or at http://www.llnl.gov/visit/copyright.html.
+*
+* Redistribution  and  use  in  source  and  binary  forms,  with  or  without
+* modification, are permitted provided that the following conditions are met:
+*
+*  - Redistributions of  source code must  retain the above  copyright notice,
+*    this list of conditions and the disclaimer below.
+*  - Redistributions in binary form must reproduce the above copyright notice,
+*    this  list of  conditions  and  the  disclaimer (as noted below)  in  the
+*    documentation and/or other materials provided with the distribution.
+*  - Neither the name of  the LLNS/LLNL nor the names of  its contributors may
+*    be used to endorse or promote products derived from this software without
+*    specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT  HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR  IMPLIED WARRANTIES, INCLUDING,  BUT NOT  LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND  FITNESS FOR A PARTICULAR  PURPOSE
+* ARE  DISCLAIMED. IN  NO EVENT  SHALL LAWRENCE  LIVERMORE NATIONAL  SECURITY,
+* LLC, THE  U.S.  DEPARTMENT OF  ENERGY  OR  CONTRIBUTORS BE  LIABLE  FOR  ANY
+* DIRECT,  INDIRECT,   INCIDENTAL,   SPECIAL,   EXEMPLARY,  OR   CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT  LIMITED TO, PROCUREMENT OF  SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF  USE, DATA, OR PROFITS; OR  BUSINESS INTERRUPTION) HOWEVER
+* CAUSED  AND  ON  ANY  THEORY  OF  LIABILITY,  WHETHER  IN  CONTRACT,  STRICT
+* LIABILITY, OR TORT  (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY  WAY
+* OUT OF THE  USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+* DAMAGE.
+*
+*****************************************************************************/
+
+
+
+
+// ************************************************************************* //
+//                              DepositionGrid.h                             //
+// ************************************************************************* //
+
+#ifndef DEPOSITION_GRID_H
+#define DEPOSITION_GRID_H
+
+#include <algorithm>
+#include <cmath>
+
+#include <vtkFloatArray.h>
+#include <vtkRectilinearGrid.h>
+
+
+// ****************************************************************************
+//  Class: DepositionGrid
+//
+//  Purpose:
+//      Deposits particle quantities (e.g. masses) onto a regular grid that
+//      covers the (periodic) simulation box, so that fields like the density
+//      can be plotted as a rectilinear mesh instead of as particles.
+//
+//  Programmer: Bert Vandenbroucke
+//  Creation:   Sun Oct 18 02:03:51 CEST 2026
+//
+//  The grid has the same number of cells in every direction and starts at
+//  the origin; in 2D, it is a single layer of cells. Particles without a
+//  smoothing length are deposited with the cloud-in-cell (CIC) scheme.
+//  Particles with a smoothing length h (taken to be the radius of the kernel
+//  support, as in Gadget) are spread over the cells with a center within h
+//  with a cubic spline kernel. The kernel weights of every particle are
+//  normalized, so that the total deposited quantity is conserved even if the
+//  kernel only covers a few cells, and particles with h smaller than a cell
+//  fall back to CIC. Deposits that cross the box boundary are wrapped
+//  around.
+//  Particles are deposited in parallel (with OpenMP); particles that
+//  overlap add to the same cells with atomic updates. The grid values are
+//  the sums of the deposited quantities; dividing by the cell volume gives a
+//  density, dividing by a mass grid a mass weighted average.
+//
+// ****************************************************************************
+
+class DepositionGrid
+{
+  private:
+    unsigned int _ndim;
+    long long _ncell;
+    double _width[3];
+
+    // cubic spline kernel as a function of the distance in units of the
+    // support radius (not normalized: the weights are normalized per
+    // particle)
+    static double kernel(double q){
+        if(q < 0.5){
+            return 1. - 6.*q*q + 6.*q*q*q;
+        }
+        if(q < 1.){
+            double t = 1. - q;
+            return 2.*t*t*t;
+        }
+        return 0.;
+    }
+
+    long long get_index(long long ix, long long iy, long long iz) const {
+        ix %= _ncell;
+        iy %= _ncell;
+        iz %= _ncell;
+        ix += ix < 0 ? _ncell : 0;
+        iy += iy < 0 ? _ncell : 0;
+        iz += iz < 0 ? _ncell : 0;
+        // x varies fastest, as VTK expects
+        return (iz*_ncell + iy)*_ncell + ix;
+    }
+
+    static void add(float *grid, long long index, float value){
+#pragma omp atomic
+        grid[index] += value;
+    }
+
+    void deposit_cic(const float *x, double weight, float *grid) const {
+        long long first[3] = {0, 0, 0};
+        double fraction[3] = {0., 0., 0.};
+        for(unsigned int k = 0; k < _ndim; k++){
+            double u = x[k]/_width[k] - 0.5;
+            double ufloor = std::floor(u);
+            first[k] = (long long)ufloor;
+            fraction[k] = u - ufloor;
+        }
+        unsigned int nz = _ndim == 3 ? 2 : 1;
+        for(unsigned int dz = 0; dz < nz; dz++){
+            double wz = dz ? fraction[2] : 1. - fraction[2];
+            for(unsigned int dy = 0; dy < 2; dy++){
+                double wy = wz*(dy ? fraction[1] : 1. - fraction[1]);
+                for(unsigned int dx = 0; dx < 2; dx++){
+                    double w = wy*(dx ? fraction[0] : 1. - fraction[0]);
+                    add(grid, get_index(first[0] + dx, first[1] + dy,
+                                        first[2] + dz), weight*w);
+                }
+            }
+        }
+    }
+
+    void deposit_sph(const float *x, double h, double weight,
+                     float *grid) const {
+        if(!(h > 0.)){
+            deposit_cic(x, weight, grid);
+            return;
+        }
+        // range of cells with a center within h from the particle
+        long long first[3] = {0, 0, 0};
+        long long last[3] = {0, 0, 0};
+        for(unsigned int k = 0; k < _ndim; k++){
+            first[k] = (long long)std::ceil((x[k] - h)/_width[k] - 0.5);
+            last[k] = (long long)std::floor((x[k] + h)/_width[k] - 0.5);
+            if(last[k] < first[k]){
+                deposit_cic(x, weight, grid);
+                return;
+            }
+            // a kernel larger than the box covers every cell only once
+            last[k] = std::min(last[k], first[k] + _ncell - 1);
+        }
+        double norm = 0.;
+        for(unsigned int pass = 0; pass < 2; pass++){
+            for(long long iz = first[2]; iz <= last[2]; iz++){
+                double dz = _ndim == 3 ? (iz + 0.5)*_width[2] - x[2] : 0.;
+                for(long long iy = first[1]; iy <= last[1]; iy++){
+                    double dy = (iy + 0.5)*_width[1] - x[1];
+                    for(long long ix = first[0]; ix <= last[0]; ix++){
+                        double dx = (ix + 0.5)*_width[0] - x[0];
+                        double w = kernel(std::sqrt(dx*dx + dy*dy + dz*dz)/h);
+                        if(!pass){
+                            norm += w;
+                        } else if(w > 0.){
+                            add(grid, get_index(ix, iy, iz), weight*w/norm);
+                        }
+                    }
+                }
+            }
+            if(norm <= 0.){
+                deposit_cic(x, weight, grid);
+                return;
+            }
+        }
+    }
+
+  public:
+    DepositionGrid() : _ndim(0), _ncell(0) {
+        for(unsigned int k = 0; k < 3; k++){
+            _width[k] = 0.;
+        }
+    }
+
+    // set up a grid with ncell cells per dimension for the given box
+    void set(unsigned int ndim, unsigned int ncell, const double *box){
+        _ndim = ndim;
+        _ncell = ncell;
+        for(unsigned int k = 0; k < 3; k++){
+            _width[k] = (k < ndim && ncell) ? box[k]/ncell : 0.;
+        }
+    }
+
+    // number of cells in the given direction
+    unsigned int get_number_of_cells(unsigned int k) const {
+        return k < _ndim ? _ncell : 1;
+    }
+
+    unsigned long long get_size() const {
+        unsigned long long size = 1;
+        for(unsigned int k = 0; k < 3; k++){
+            size *= get_number_of_cells(k);
+        }
+        return size;
+    }
+
+    // volume (area in 2D) of a cell
+    double get_cell_volume() const {
+        double volume = 1.;
+        for(unsigned int k = 0; k < _ndim; k++){
+            volume *= _width[k];
+        }
+        return volume;
+    }
+
+    // the grid as a VTK mesh (with a single layer of points in z in 2D)
+    vtkRectilinearGrid *get_mesh() const {
+        vtkRectilinearGrid *mesh = vtkRectilinearGrid::New();
+        int dims[3];
+        vtkFloatArray *faces[3];
+        for(unsigned int k = 0; k < 3; k++){
+            dims[k] = k < _ndim ? _ncell + 1 : 1;
+            faces[k] = vtkFloatArray::New();
+            faces[k]->SetNumberOfTuples(dims[k]);
+            float *data = (float*)faces[k]->GetVoidPointer(0);
+            for(int i = 0; i < dims[k]; i++){
+                data[i] = i*_width[k];
+            }
+        }
+        mesh->SetDimensions(dims);
+        mesh->SetXCoordinates(faces[0]);
+        mesh->SetYCoordinates(faces[1]);
+        mesh->SetZCoordinates(faces[2]);
+        for(unsigned int k = 0; k < 3; k++){
+            faces[k]->Delete();
+        }
+        return mesh;
+    }
+
+    // add factor*weights*values (values can be NULL) of n particles with
+    // the given positions (3 per particle) and smoothing lengths (or NULL
+    // for CIC) to the grid
+    void deposit(const float *positions, const float *h,
+                 const float *weights, const float *values,
+                 unsigned long long n, double factor, float *grid) const {
+        long long nloop = n;
+        // the cost per particle depends on its smoothing length
+#pragma omp parallel for schedule(dynamic, 1024)
+        for(long long i = 0; i < nloop; i++){
+            double weight = factor*weights[i];
+            if(values){
+                weight *= values[i];
+            }
+            if(weight == 0.){
+                continue;
+            }
+            if(h){
+                deposit_sph(&positions[3*i], h[i], weight, grid);
+            } else {
+                deposit_cic(&positions[3*i], weight, grid);
+            }
+        }
+    }
+
+    // divide the n values by the corresponding values of a mass grid (0 if
+    // there is no mass in a cell)
+    static void divide(float *data, const float *mass, unsigned long long n){
+        long long nloop = n;
+#pragma omp parallel for schedule(static)
+        for(long long i = 0; i < nloop; i++){
+            data[i] = mass[i] > 0.f ? data[i]/mass[i] : 0.f;
+        }
+    }
+};
+
+
+#endif
@@ -0,0 +1,135 @@
+/*****************************************************************************
+*
+* Copyright (c) 2000 - 2013, Lawrence Livermore National Security, LLC
+* Produced at the Lawrence Livermore National Laboratory
+* LLNL-CODE-442911
+* All rights reserved.
+*
+* This file is  part of VisIt. For  details, see https://visit.llnl.gov/.  The
+* full copyright notice is contained in the file COPYRIGHT located at the root
+* of the VisIt distribution or at http://www.llnl.gov/visit/copyright.html.
+*
+* Redistribution  and  use  in  source  and  binary  forms,  with  or  without
+* modification, are permitted provided that the following conditions are met:
+*
+*  - Redistributions of  source code must  retain the above  copyright notice,
+*    this list of conditions and the disclaimer below.
+*  - Redistributions in binary form must reproduce the above copyright notice,
+*    this  list of  conditions  and  the  disclaimer (as noted below)  in  the
+*    documentation and/or other materials provided with the distribution.
+*  - Neither the name of  the LLNS/LLNL nor the names of  its contributors may
+*    be used to endorse or promote products derived from this software without
+*    specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT  HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR  IMPLIED WARRANTIES, INCLUDING,  BUT NOT  LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND  FITNESS FOR A PARTICULAR  PURPOSE
+* ARE  DISCLAIMED. IN  NO EVENT  SHALL LAWRENCE  LIVERMORE NATIONAL  SECURITY,
+* LLC, THE  U.S.  DEPARTMENT OF  ENERGY  OR  CONTRIBUTORS BE  LIABLE  FOR  ANY
+* DIRECT,  INDIRECT,   INCIDENTAL,   SPECIAL,   EXEMPLARY,  OR   CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT  LIMITED TO, PROCUREMENT OF  SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF  USE, DATA, OR PROFITS; OR  BUSINESS INTERRUPTION) HOWEVER
+* CAUSED  AND  ON  ANY  THEORY  OF  LIABILITY,  WHETHER  IN  CONTRACT,  STRICT
+* LIABILITY, OR TORT  (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY  WAY
+* OUT OF THE  USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+* DAMAGE.
+*
+*****************************************************************************/
+
+
+// ************************************************************************* //
+//                              DerivedFields.h                              //
+// ************************************************************************* //
+
+#ifndef DERIVED_FIELDS_H
+#define DERIVED_FIELDS_H
+
+#include <cmath>
+
+
+// ****************************************************************************
+//  Class: DerivedFields
+//
+//  Purpose:
+//      Computes variables that are not stored in a snapshot, but can be
+//      derived from the data that is stored in it (e.g. the radius of the
+//      particles, or the temperature of the gas).
+//
+//  Programmer: Bert Vandenbroucke
+//  Creation:   Sat Oct 17 20:06:13 CEST 2026
+//
+//  Every derived variable is computed in a single multithreaded pass over
+//  the data it depends on, straight into the VTK array that is returned to
+//  VisIt. This is a lot cheaper than an expression, for which VisIt
+//  evaluates every operation separately, using a temporary array for every
+//  intermediate result.
+//  The coordinates can be passed on as separate arrays (stride 1) or as
+//  interleaved components (stride 3).
+//
+// ****************************************************************************
+
+class DerivedFields
+{
+  public:
+    // the temperature of a gas with a specific internal energy of 1 in the
+    // given velocity unit (in cm/s), for a fully ionized gas of primordial
+    // composition (hydrogen mass fraction 0.76) with adiabatic index 5/3
+    static double get_temperature_factor(double unit_velocity){
+        const double gamma = 5./3.;
+        const double mu = 4./(3. + 5.*0.76);
+        const double m_H = 1.6737236e-24;
+        const double k_B = 1.380649e-16;
+        return (gamma - 1.)*mu*m_H/k_B*unit_velocity*unit_velocity;
+    }
+
+    // compute the distance of n particles to the given center, multiplied
+    // with scale. If box[k] > 0, coordinate k is periodic with period box[k]
+    // and we use the distance to the nearest periodic copy of the center
+    template<typename T>
+    static void radius(const T *const *coords, unsigned int ndim,
+                       unsigned int stride, unsigned long long n,
+                       const double *center, const double *box, double scale,
+                       float *radius){
+        long long nloop = n;
+#pragma omp parallel for schedule(static)
+        for(long long i = 0; i < nloop; i++){
+            double r2 = 0.;
+            for(unsigned int k = 0; k < ndim; k++){
+                double dx = coords[k][i*stride] - center[k];
+                if(box[k] > 0.){
+                    if(dx > 0.5*box[k]){
+                        dx -= box[k];
+                    } else if(dx < -0.5*box[k]){
+                        dx += box[k];
+                    }
+                }
+                r2 += dx*dx;
+            }
+            radius[i] = scale*std::sqrt(r2);
+        }
+    }
+
+    // multiply n values with the given factor, in place (e.g. to convert
+    // specific internal energies to temperatures)
+    static void multiply(float *data, unsigned long long n, double factor){
+        long long nloop = n;
+        float ffactor = factor;
+#pragma omp parallel for schedule(static)
+        for(long long i = 0; i < nloop; i++){
+            data[i] *= ffactor;
+        }
+    }
+
+    // set n values to the given constant (e.g. the mass of particles that
+    // all have the same mass, which is not stored per particle)
+    static void fill(float *data, unsigned long long n, float value){
+        long long nloop = n;
+#pragma omp parallel for schedule(static)
+        for(long long i = 0; i < nloop; i++){
+            data[i] = value;
+        }
+    }
+};
+
+
+#endif
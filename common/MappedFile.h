@@ -0,0 +1,207 @@
+/*****************************************************************************
+*
+* Copyright (c) 2000 - 2013, Lawrence Livermore National Security, LLC
+* Produced at the Lawrence Livermore National Laboratory
+* LLNL-CODE-442911
+* All rights reserved.
+*
+* This file is  part of VisIt. For  details, see https://visit.llnl.gov/.  The
+* full copyright notice is contained in the file COPYRIGHT located at the root
+* of the VisIt distribution or at http://www.llnl.gov/visit/copyright.html.
+*
+* Redistribution  and  use  in  source  and  binary  forms,  with  or  without
+* modification, are permitted provided that the following conditions are met:
+*
+*  - Redistributions of  source code must  retain the above  copyright notice,
+*    this list of conditions and the disclaimer below.
+*  - Redistributions in binary form must reproduce the above copyright notice,
+*    this  list of  conditions  and  the  disclaimer (as noted below)  in  the
+*    documentation and/or other materials provided with the distribution.
+*  - Neither the name of  the LLNS/LLNL nor the names of  its contributors may
+*    be used to endorse or promote products derived from this software without
+*    specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT  HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR  IMPLIED WARRANTIES, INCLUDING,  BUT NOT  LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND  FITNESS FOR A PARTICULAR  PURPOSE
+* ARE  DISCLAIMED. IN  NO EVENT  SHALL LAWRENCE  LIVERMORE NATIONAL  SECURITY,
+* LLC, THE  U.S.  DEPARTMENT OF  ENERGY  OR  CONTRIBUTORS BE  LIABLE  FOR  ANY
+* DIRECT,  INDIRECT,   INCIDENTAL,   SPECIAL,   EXEMPLARY,  OR   CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT  LIMITED TO, PROCUREMENT OF  SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF  USE, DATA, OR PROFITS; OR  BUSINESS INTERRUPTION) HOWEVER
+* CAUSED  AND  ON  ANY  THEORY  OF  LIABILITY,  WHETHER  IN  CONTRACT,  STRICT
+* LIABILITY, OR TORT  (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY  WAY
+* OUT OF THE  USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+* DAMAGE.
+*
+*****************************************************************************/
+
+
+// ************************************************************************* //
+//                               MappedFile.h                                //
+// ************************************************************************* //
+
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <algorithm>
+#include <string>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+// ****************************************************************************
+//  Class: MappedFile
+//
+//  Purpose:
+//      Maps a complete (binary) snapshot file into memory, so that data can
+//      be copied straight from the file into VTK arrays, at any 64-bit
+//      offset, without seeking and without intermediate buffers.
+//
+//  Programmer: Bert Vandenbroucke
+//  Creation:   Sat Oct 17 17:31:06 CEST 2026
+//
+//  The mapping is read-only and is only backed by the page cache: mapping a
+//  file that is much larger than the available memory is fine, since only
+//  the pages that are actually accessed are read. advise() tells the kernel
+//  how a part of the file will be accessed, so that it can read ahead (or
+//  not). The file is unmapped by close() or when the object is destroyed.
+//
+// ****************************************************************************
+
+class MappedFile
+{
+  private:
+    const char *_data;
+    unsigned long long _size;
+#ifdef _WIN32
+    HANDLE _file;
+    HANDLE _mapping;
+#endif
+
+    // copying would unmap the file twice
+    MappedFile(const MappedFile&);
+    MappedFile &operator=(const MappedFile&);
+
+  public:
+#ifdef _WIN32
+    MappedFile() : _data(NULL), _size(0), _file(INVALID_HANDLE_VALUE),
+                   _mapping(NULL) {}
+#else
+    MappedFile() : _data(NULL), _size(0) {}
+#endif
+
+    ~MappedFile(){
+        close();
+    }
+
+    // map the given file. Returns false if this fails.
+    bool open(const std::string &filename){
+        close();
+#ifdef _WIN32
+        _file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ,
+                            NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+        if(_file == INVALID_HANDLE_VALUE){
+            return false;
+        }
+        LARGE_INTEGER size;
+        if(!GetFileSizeEx(_file, &size) || !size.QuadPart){
+            close();
+            return false;
+        }
+        _size = size.QuadPart;
+        _mapping = CreateFileMappingA(_file, NULL, PAGE_READONLY, 0, 0, NULL);
+        if(_mapping == NULL){
+            close();
+            return false;
+        }
+        _data = (const char*)MapViewOfFile(_mapping, FILE_MAP_READ, 0, 0, 0);
+        if(_data == NULL){
+            close();
+            return false;
+        }
+#else
+        int fd = ::open(filename.c_str(), O_RDONLY);
+        if(fd < 0){
+            return false;
+        }
+        struct stat buffer;
+        if(fstat(fd, &buffer) || !buffer.st_size){
+            ::close(fd);
+            return false;
+        }
+        _size = buffer.st_size;
+        void *data = mmap(NULL, _size, PROT_READ, MAP_SHARED, fd, 0);
+        // the mapping stays valid after the file descriptor is closed
+        ::close(fd);
+        if(data == MAP_FAILED){
+            _size = 0;
+            return false;
+        }
+        _data = (const char*)data;
+#endif
+        return true;
+    }
+
+    void close(){
+#ifdef _WIN32
+        if(_data){
+            UnmapViewOfFile(_data);
+        }
+        if(_mapping != NULL){
+            CloseHandle(_mapping);
+        }
+        if(_file != INVALID_HANDLE_VALUE){
+            CloseHandle(_file);
+        }
+        _mapping = NULL;
+        _file = INVALID_HANDLE_VALUE;
+#else
+        if(_data){
+            munmap((void*)_data, _size);
+        }
+#endif
+        _data = NULL;
+        _size = 0;
+    }
+
+    bool is_open() const {
+        return _data != NULL;
+    }
+
+    const char *get_data() const {
+        return _data;
+    }
+
+    unsigned long long get_size() const {
+        return _size;
+    }
+
+    // tell the kernel that [offset, offset+size[ will be accessed
+    // sequentially (so that it reads ahead aggressively) or randomly (so
+    // that it does not read more than the pages we access)
+    void advise(unsigned long long offset, unsigned long long size,
+                bool sequential) const {
+#ifndef _WIN32
+        if(!_data || offset >= _size){
+            return;
+        }
+        size = std::min(size, _size - offset);
+        // madvise needs a page aligned start address
+        unsigned long long page = sysconf(_SC_PAGESIZE);
+        unsigned long long start = offset/page*page;
+        madvise((void*)(_data + start), size + offset - start,
+                sequential ? MADV_SEQUENTIAL : MADV_RANDOM);
+#endif
+    }
+};
+
+
+#endif
@@ -0,0 +1,253 @@
+/*****************************************************************************
+*
+* Copyright (c) 2000 - 2013, Lawrence Livermore National Security, LLC
+* Produced at the Lawrence Livermore National Laboratory
+* LLNL-CODE-442911
+* All rights reserved.
+*
+* This file is  part of VisIt. For  details, see https://visit.llnl.gov/.  The
+* full copyright notice is contained in the file COPYRIGHT located at the root
+* of the VisIt distribution or at http://www.llnl.gov/visit/copyright.html.
+*
+* Redistribution  and  use  in  source  and  binary  forms,  with  or  without
+* modification, are permitted provided that the following conditions are met:
+*
+*  - Redistributions of  source code must  retain the above  copyright notice,
+*    this list of conditions and the disclaimer below.
+*  - Redistributions in binary form must reproduce the above copyright notice,
+*    this  list of  conditions  and  the  disclaimer (as noted below)  in  the
+*    documentation and/or other materials provided with the distribution.
+*  - Neither the name of  the LLNS/LLNL nor the names of  its contributors may
+*    be used to endorse or promote products derived from this software without
+*    specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT  HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR  IMPLIED WARRANTIES, INCLUDING,  BUT NOT  LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND  FITNESS FOR A PARTICULAR  PURPOSE
+* ARE  DISCLAIMED. IN  NO EVENT  SHALL LAWRENCE  LIVERMORE NATIONAL  SECURITY,
+* LLC, THE  U.S.  DEPARTMENT OF  ENERGY  OR  CONTRIBUTORS BE  LIABLE  FOR  ANY
+* DIRECT,  INDIRECT,   INCIDENTAL,   SPECIAL,   EXEMPLARY,  OR   CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT  LIMITED TO, PROCUREMENT OF  SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF  USE, DATA, OR PROFITS; OR  BUSINESS INTERRUPTION) HOWEVER
+* CAUSED  AND  ON  ANY  THEORY  OF  LIABILITY,  WHETHER  IN  CONTRACT,  STRICT
+* LIABILITY, OR TORT  (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY  WAY
+* OUT OF THE  USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+* DAMAGE.
+*
+*****************************************************************************/
+
+
+
+
+// ************************************************************************* //
+//                              ParticleIndex.h                              //
+// ************************************************************************* //
+
+#ifndef PARTICLE_INDEX_H
+#define PARTICLE_INDEX_H
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <MappedFile.h>
+#include <SidecarFile.h>
+
+
+// ****************************************************************************
+//  Class: ParticleIndex
+//
+//  Purpose:
+//      Maps particle IDs to the rows at which the particles are stored in a
+//      snapshot file, so that a small set of particles can be followed
+//      through a time series without reading all particles of every
+//      snapshot.
+//
+//  Programmer: Bert Vandenbroucke
+//  Creation:   Sun Oct 18 01:14:29 CEST 2026
+//
+//  For every particle type, the index contains the IDs of all particles in
+//  the file in ascending order, followed by the rows of the corresponding
+//  particles. Building the index requires a full read of the IDs, so it is
+//  stored in a sidecar file next to the snapshot (see SidecarFile). Once it
+//  exists, the sidecar file is mapped into memory rather than read, and a
+//  lookup is a binary search that only touches the pages that contain the
+//  IDs that are looked up, so that the cost of a lookup does not depend on
+//  the number of particles in the file.
+//
+// ****************************************************************************
+
+class ParticleIndex
+{
+  private:
+    // sorted IDs and corresponding rows per type, in _file or in _memory
+    std::vector<const unsigned long long*> _ids;
+    std::vector<const unsigned long long*> _rows;
+    std::vector<unsigned long long> _count;
+    MappedFile _file;
+    std::vector<unsigned long long> _memory;
+
+    // the IDs of a type are followed by its rows, then comes the next type
+    void set_pointers(const unsigned long long *data){
+        _ids.resize(_count.size());
+        _rows.resize(_count.size());
+        for(unsigned int type = 0; type < _count.size(); type++){
+            _ids[type] = data;
+            _rows[type] = data + _count[type];
+            data += 2*_count[type];
+        }
+    }
+
+  public:
+    void clear(){
+        _ids.clear();
+        _rows.clear();
+        _count.clear();
+        _file.close();
+        _memory.clear();
+    }
+
+    // map the index stored in the sidecar file of the given snapshot.
+    // Returns false if there is no (valid) sidecar file
+    bool read(const std::string &snapshot){
+        clear();
+        SidecarFile file(snapshot, ".idindex");
+        if(!file.open_read("IDINDEX ", 1)){
+            return false;
+        }
+        unsigned int ntype = 0;
+        file.read(ntype);
+        if(!file.good() || ntype == 0 || ntype > 64){
+            return false;
+        }
+        std::vector<unsigned long long> count(ntype);
+        file.read(&count[0], ntype);
+        unsigned long long offset = file.tell();
+        if(!file.good() || offset%sizeof(unsigned long long)){
+            return false;
+        }
+        if(!_file.open(file.get_name()) || _file.get_size() < offset){
+            _file.close();
+            return false;
+        }
+        unsigned long long available =
+            (_file.get_size() - offset)/sizeof(unsigned long long);
+        for(unsigned int type = 0; type < ntype; type++){
+            if(count[type] > available/2){
+                _file.close();
+                return false;
+            }
+            available -= 2*count[type];
+        }
+        // lookups jump around in the file: do not read ahead
+        _file.advise(offset, _file.get_size() - offset, false);
+        _count.swap(count);
+        set_pointers(
+            reinterpret_cast<const unsigned long long*>(_file.get_data() +
+                                                        offset));
+        return true;
+    }
+
+    // build the index in memory. reader(type, ids) fills ids with the IDs of
+    // the particles of the given type, in the order in which they are stored
+    template<typename Reader> void build(unsigned int ntype, Reader &reader){
+        clear();
+        _count.resize(ntype, 0);
+        std::vector<unsigned long long> ids;
+        std::vector< std::pair<unsigned long long, unsigned long long> > pairs;
+        for(unsigned int type = 0; type < ntype; type++){
+            ids.clear();
+            reader(type, ids);
+            unsigned long long n = ids.size();
+            pairs.resize(n);
+            for(unsigned long long i = 0; i < n; i++){
+                pairs[i] = std::make_pair(ids[i], i);
+            }
+            std::sort(pairs.begin(), pairs.end());
+            unsigned long long offset = _memory.size();
+            _memory.resize(offset + 2*n);
+            for(unsigned long long i = 0; i < n; i++){
+                _memory[offset + i] = pairs[i].first;
+                _memory[offset + n + i] = pairs[i].second;
+            }
+            _count[type] = n;
+        }
+        set_pointers(_memory.empty() ? NULL : &_memory[0]);
+    }
+
+    // store the index in the sidecar file of the given snapshot
+    bool write(const std::string &snapshot){
+        if(_count.empty()){
+            return false;
+        }
+        SidecarFile file(snapshot, ".idindex");
+        if(!file.open_write("IDINDEX ", 1)){
+            return false;
+        }
+        unsigned int ntype = _count.size();
+        file.write(ntype);
+        file.write(&_count[0], ntype);
+        for(unsigned int type = 0; type < ntype; type++){
+            file.write(_ids[type], _count[type]);
+            file.write(_rows[type], _count[type]);
+        }
+        return file.commit();
+    }
+
+    // find the particles of the given type with the given (sorted) IDs.
+    // For every ID that is found, a pair (row, index in ids) is added to
+    // matches, in the order of the IDs
+    void find(unsigned int type, const std::vector<unsigned long long> &ids,
+              std::vector< std::pair<unsigned long long,
+                                     unsigned long long> > &matches) const {
+        if(type >= _count.size() || !_count[type]){
+            return;
+        }
+        const unsigned long long *begin = _ids[type];
+        const unsigned long long *end = begin + _count[type];
+        // the IDs are sorted: every search starts where the previous ended
+        const unsigned long long *it = begin;
+        for(unsigned long long i = 0; i < ids.size(); i++){
+            it = std::lower_bound(it, end, ids[i]);
+            if(it == end){
+                break;
+            }
+            if(*it == ids[i]){
+                matches.push_back(std::make_pair(_rows[type][it - begin], i));
+            }
+        }
+    }
+
+    // read a list of IDs from a text file: IDs are separated by white space,
+    // and everything after a '#' on a line is ignored. The IDs are sorted
+    // and duplicates are removed. Returns false if the file cannot be read
+    static bool read_id_list(const std::string &filename,
+                             std::vector<unsigned long long> &ids){
+        std::ifstream stream(filename.c_str());
+        if(!stream.is_open()){
+            return false;
+        }
+        ids.clear();
+        std::string line;
+        while(std::getline(stream, line)){
+            std::string::size_type comment = line.find('#');
+            if(comment != std::string::npos){
+                line.erase(comment);
+            }
+            std::istringstream words(line);
+            unsigned long long id;
+            while(words >> id){
+                ids.push_back(id);
+            }
+        }
+        std::sort(ids.begin(), ids.end());
+        ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+        return true;
+    }
+};
+
+
+#endif
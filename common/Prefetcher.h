@@ -0,0 +1,336 @@
+/*****************************************************************************
+*
+* Copyright (c) 2000 - 2013, Lawrence Livermore National Security, LLC
+* Produced at the Lawrence Livermore National Laboratory
+* LLNL-CODE-442911
+* All rights reserved.
+*
+* This file is  part of VisIt. For  details, see https://visit.llnl.gov/.  The
+* full copyright notice is contained in the file COPYRIGHT located at the root
+* of the VisIt distribution or at http://www.llnl.gov/visit/copyright.html.
+*
+* Redistribution  and  use  in  source  and  binary  forms,  with  or  without
+* modification, are permitted provided that the following conditions are met:
+*
+*  - Redistributions of  source code must  retain the above  copyright notice,
+*    this list of conditions and the disclaimer below.
+*  - Redistributions in binary form must reproduce the above copyright notice,
+*    this  list of  conditions  and  the  disclaimer (as noted below)  in  the
+*    documentation and/or other materials provided with the distribution.
+*  - Neither the name of  the LLNS/LLNL nor the names of  its contributors may
+*    be used to endorse or promote products derived from this software without
+*    specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT  HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR  IMPLIED WARRANTIES, INCLUDING,  BUT NOT  LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND  FITNESS FOR A PARTICULAR  PURPOSE
+* ARE  DISCLAIMED. IN  NO EVENT  SHALL LAWRENCE  LIVERMORE NATIONAL  SECURITY,
+* LLC, THE  U.S.  DEPARTMENT OF  ENERGY  OR  CONTRIBUTORS BE  LIABLE  FOR  ANY
+* DIRECT,  INDIRECT,   INCIDENTAL,   SPECIAL,   EXEMPLARY,  OR   CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT  LIMITED TO, PROCUREMENT OF  SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF  USE, DATA, OR PROFITS; OR  BUSINESS INTERRUPTION) HOWEVER
+* CAUSED  AND  ON  ANY  THEORY  OF  LIABILITY,  WHETHER  IN  CONTRACT,  STRICT
+* LIABILITY, OR TORT  (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY  WAY
+* OUT OF THE  USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+* DAMAGE.
+*
+*****************************************************************************/
+
+
+// ************************************************************************* //
+//                               Prefetcher.h                                //
+// ************************************************************************* //
+
+#ifndef PREFETCHER_H
+#define PREFETCHER_H
+
+#include <cctype>
+#include <cstdlib>
+#include <deque>
+#include <map>
+#include <set>
+#include <sstream>
+#include <string>
+
+#ifndef _WIN32
+#include <dirent.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+
+// ****************************************************************************
+//  Class: Prefetcher
+//
+//  Purpose:
+//      Reads the parts of the next snapshot of a time series that will most
+//      likely be needed next in a background thread, while VisIt is still
+//      busy with the current snapshot, so that animating through a time
+//      series is not limited by the speed of the file system.
+//
+//  Programmer: Bert Vandenbroucke
+//  Creation:   Sat Oct 17 20:44:58 CEST 2026
+//
+//  The next snapshot is the file in the same directory whose name only
+//  differs in the cycle number, with the smallest cycle number larger than
+//  the current one. Subsequent snapshots of a simulation have (almost) the
+//  same layout, so the parts of the next snapshot we need are at the same
+//  offsets as the parts of the current snapshot we just read. The plugins
+//  pass on these offsets after every read, and the background thread reads
+//  them from the next snapshot, in chunks of 1 MiB into a single buffer that
+//  is then discarded. This only leaves the data in the page cache of the
+//  operating system, which is bounded by the available memory and does not
+//  need any coordination with the instance of the plugin that later opens
+//  the next snapshot.
+//  Every range is only prefetched once. The background thread is stopped
+//  when the Prefetcher is destroyed. Prefetching is not supported on
+//  Windows.
+//
+//  Modifications:
+//    Bert Vandenbroucke, Sun Oct 18 05:58:23 CEST 2026
+//    Added clear(), which forgets the next snapshots and queued ranges, so
+//    that they do not accumulate over a time series.
+//
+// ****************************************************************************
+
+class Prefetcher
+{
+  private:
+    class Range{
+    public:
+        std::string _filename;
+        unsigned long long _offset;
+        // 0 means the complete file
+        unsigned long long _size;
+
+        Range(const std::string &filename, unsigned long long offset,
+              unsigned long long size)
+            : _filename(filename), _offset(offset), _size(size) {}
+    };
+
+    // name of the next snapshot for every file we have seen
+    std::map<std::string, std::string> _next;
+    // ranges that have been queued before
+    std::set<std::string> _queued;
+    std::deque<Range> _queue;
+
+#ifndef _WIN32
+    pthread_t _thread;
+    pthread_mutex_t _mutex;
+    bool _started;
+    bool _running;
+    bool _stop;
+
+    // read one range, unless we are asked to stop
+    void read_range(const Range &range, char *buffer, unsigned int size){
+        int fd = open(range._filename.c_str(), O_RDONLY);
+        if(fd < 0){
+            return;
+        }
+        unsigned long long end = range._offset + range._size;
+        if(!range._size){
+            end = lseek(fd, 0, SEEK_END);
+        }
+        for(unsigned long long offset = range._offset; offset < end;
+            offset += size){
+            pthread_mutex_lock(&_mutex);
+            bool stop = _stop;
+            pthread_mutex_unlock(&_mutex);
+            unsigned long long chunk = end - offset;
+            if(chunk > size){
+                chunk = size;
+            }
+            if(stop || pread(fd, buffer, chunk, offset) <= 0){
+                break;
+            }
+        }
+        ::close(fd);
+    }
+
+    // background thread: read ranges until the queue is empty
+    static void *run(void *arg){
+        Prefetcher *prefetcher = reinterpret_cast<Prefetcher*>(arg);
+        const unsigned int size = 1 << 20;
+        char *buffer = new char[size];
+        while(true){
+            pthread_mutex_lock(&prefetcher->_mutex);
+            if(prefetcher->_stop || prefetcher->_queue.empty()){
+                prefetcher->_running = false;
+                pthread_mutex_unlock(&prefetcher->_mutex);
+                break;
+            }
+            Range range = prefetcher->_queue.front();
+            prefetcher->_queue.pop_front();
+            pthread_mutex_unlock(&prefetcher->_mutex);
+            prefetcher->read_range(range, buffer, size);
+        }
+        delete [] buffer;
+        return NULL;
+    }
+#endif
+
+    // copying would copy the thread
+    Prefetcher(const Prefetcher&);
+    Prefetcher &operator=(const Prefetcher&);
+
+  public:
+#ifndef _WIN32
+    Prefetcher() : _started(false), _running(false), _stop(false) {
+        pthread_mutex_init(&_mutex, NULL);
+    }
+
+    ~Prefetcher(){
+        stop();
+        pthread_mutex_destroy(&_mutex);
+    }
+
+    // stop the background thread and forget about the queued ranges
+    void stop(){
+        pthread_mutex_lock(&_mutex);
+        _stop = true;
+        _queue.clear();
+        pthread_mutex_unlock(&_mutex);
+        if(_started){
+            pthread_join(_thread, NULL);
+            _started = false;
+        }
+        _stop = false;
+    }
+#else
+    Prefetcher() {}
+
+    void stop() {}
+#endif
+
+    // forget the next snapshots and the ranges that were queued before (the
+    // background thread still reads the ranges that are in the queue)
+    void clear(){
+        _next.clear();
+        _queued.clear();
+    }
+
+    // get the name of the snapshot that follows the given snapshot (with the
+    // given cycle number) in a time series, or an empty string if there is
+    // no such snapshot
+    // If length is positive, the cycle number is only looked for in the
+    // first length characters of the file name (e.g. to skip the file index
+    // of a multi-file snapshot).
+    static std::string get_next_snapshot(const std::string &filename,
+                                         int cycle, int length = -1){
+#ifndef _WIN32
+        std::string::size_type slash = filename.rfind('/');
+        std::string dirname = ".";
+        std::string basename = filename;
+        if(slash != std::string::npos){
+            dirname = filename.substr(0, slash);
+            basename = filename.substr(slash+1);
+            length -= slash+1;
+        }
+        if(length < 0 || length > (int)basename.size()){
+            length = basename.size();
+        }
+        // find the (last) run of digits with the cycle number
+        int begin = -1;
+        int end = -1;
+        for(int i = length; i > 0; i--){
+            if(isdigit(basename[i-1])){
+                int j = i;
+                while(j > 0 && isdigit(basename[j-1])){
+                    j--;
+                }
+                if(atoi(basename.substr(j, i-j).c_str()) == cycle){
+                    begin = j;
+                    end = i;
+                    break;
+                }
+                i = j;
+            }
+        }
+        if(begin < 0){
+            return "";
+        }
+        std::string prefix = basename.substr(0, begin);
+        std::string suffix = basename.substr(end);
+
+        DIR *dir = opendir(dirname.c_str());
+        if(!dir){
+            return "";
+        }
+        std::string next;
+        long long nextcycle = -1;
+        struct dirent *entry;
+        while((entry = readdir(dir))){
+            std::string name(entry->d_name);
+            if(name.size() <= prefix.size() + suffix.size() ||
+               name.compare(0, prefix.size(), prefix) ||
+               name.compare(name.size() - suffix.size(), suffix.size(),
+                            suffix)){
+                continue;
+            }
+            std::string digits = name.substr(prefix.size(), name.size() -
+                                             prefix.size() - suffix.size());
+            bool number = true;
+            for(unsigned int i = 0; i < digits.size(); i++){
+                number &= (isdigit(digits[i]) != 0);
+            }
+            long long value = atoll(digits.c_str());
+            if(number && value > cycle &&
+               (nextcycle < 0 || value < nextcycle)){
+                next = name;
+                nextcycle = value;
+            }
+        }
+        closedir(dir);
+        if(next.empty()){
+            return "";
+        }
+        return dirname + "/" + next;
+#else
+        return "";
+#endif
+    }
+
+    // prefetch the given range (or the complete file if size is 0) from the
+    // snapshot that follows the given snapshot
+    void prefetch(const std::string &filename, int cycle,
+                  unsigned long long offset, unsigned long long size,
+                  int length = -1){
+#ifndef _WIN32
+        std::map<std::string, std::string>::iterator it =
+            _next.find(filename);
+        if(it == _next.end()){
+            it = _next.insert(std::make_pair(filename,
+                      get_next_snapshot(filename, cycle, length))).first;
+        }
+        const std::string &next = it->second;
+        if(next.empty()){
+            return;
+        }
+        std::stringstream key;
+        key << next << ":" << offset << ":" << size;
+        if(!_queued.insert(key.str()).second){
+            return;
+        }
+
+        pthread_mutex_lock(&_mutex);
+        _queue.push_back(Range(next, offset, size));
+        bool running = _running;
+        pthread_mutex_unlock(&_mutex);
+        if(!running){
+            // the previous thread (if any) has finished
+            if(_started){
+                pthread_join(_thread, NULL);
+            }
+            _running = true;
+            _started = !pthread_create(&_thread, NULL, run, this);
+            if(!_started){
+                _running = false;
+            }
+        }
+#endif
+    }
+};
+
+
+#endif
@@ -0,0 +1,251 @@
+/*****************************************************************************
+*
+* Copyright (c) 2000 - 2013, Lawrence Livermore National Security, LLC
+* Produced at the Lawrence Livermore National Laboratory
+* LLNL-CODE-442911
+* All rights reserved.
+*
+* This file is  part of VisIt. For  details, see https://visit.llnl.gov/.  The
+* full copyright notice is contained in the file COPYRIGHT located at the root
+* of the VisIt distribution or at http://www.llnl.gov/visit/copyright.html.
+*
+* Redistribution  and  use  in  source  and  binary  forms,  with  or  without
+* modification, are permitted provided that the following conditions are met:
+*
+*  - Redistributions of  source code must  retain the above  copyright notice,
+*    this list of conditions and the disclaimer below.
+*  - Redistributions in binary form must reproduce the above copyright notice,
+*    this  list of  conditions  and  the  disclaimer (as noted below)  in  the
+*    documentation and/or other materials provided with the distribution.
+*  - Neither the name of  the LLNS/LLNL nor the names of  its contributors may
+*    be used to endorse or promote products derived from this software without
+*    specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT  HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR  IMPLIED WARRANTIES, INCLUDING,  BUT NOT  LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND  FITNESS FOR A PARTICULAR  PURPOSE
+* ARE  DISCLAIMED. IN  NO EVENT  SHALL LAWRENCE  LIVERMORE NATIONAL  SECURITY,
+* LLC, THE  U.S.  DEPARTMENT OF  ENERGY  OR  CONTRIBUTORS BE  LIABLE  FOR  ANY
+* DIRECT,  INDIRECT,   INCIDENTAL,   SPECIAL,   EXEMPLARY,  OR   CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT  LIMITED TO, PROCUREMENT OF  SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF  USE, DATA, OR PROFITS; OR  BUSINESS INTERRUPTION) HOWEVER
+* CAUSED  AND  ON  ANY  THEORY  OF  LIABILITY,  WHETHER  IN  CONTRACT,  STRICT
+* LIABILITY, OR TORT  (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY  WAY
+* OUT OF THE  USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+* DAMAGE.
+*
+*****************************************************************************/
+
+
+
+// ************************************************************************* //
+//                              ReadStatistics.h                             //
+// ************************************************************************* //
+
+#ifndef READ_STATISTICS_H
+#define READ_STATISTICS_H
+
+#include <fstream>
+#include <iomanip>
+#include <ostream>
+#include <sstream>
+#include <string>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/time.h>
+#endif
+
+
+// ****************************************************************************
+//  Class: ReadStatistics
+//
+//  Purpose:
+//      Keeps track of the number of calls, wall clock time and number of
+//      bytes read for the expensive phases of reading a snapshot, and of the
+//      number of calls and time spent in the methods VisIt calls, so that we
+//      can see where the time goes in a production session.
+//
+//  Programmer: Bert Vandenbroucke
+//  Creation:   Sat Oct 17 23:21:54 CEST 2026
+//
+//  The phases are: opening files and datasets and reading headers (open),
+//  reading data (read), converting data and computing derived variables and
+//  data extents (compute), and setting up the vertex cells (cells).
+//  The readers put a Timer on the stack for the duration of a phase or call.
+//  The time of a phase excludes the time of the phases nested inside it
+//  (e.g. the reads done while converting coordinates), so that the phases
+//  add up to the time spent in them; the time of a call includes
+//  everything. The bytes read are the bytes returned by HDF5 (after
+//  conversion to the memory type) or read from a binary file.
+//  The overhead is two calls to the clock per timer; timers are only used
+//  around entire reads and loops, never per particle.
+//  report() writes the statistics to a log stream (the VisIt debug logs)
+//  and appends them to a summary file (if set) as tab separated lines
+//  (plugin, snapshot, counter, calls, time in s, bytes), after which they
+//  are reset. The readers report when their resources are freed, which
+//  happens every time VisIt moves to another timestep.
+//
+// ****************************************************************************
+
+class ReadStatistics
+{
+  public:
+    enum Counter{
+        // phases
+        OPEN = 0,
+        READ,
+        COMPUTE,
+        CELLS,
+        // calls
+        POPULATE_METADATA,
+        GET_MESH,
+        GET_VAR,
+        GET_VECTOR_VAR,
+        GET_AUXILIARY_DATA,
+        NCOUNTER
+    };
+
+    static const char *get_name(Counter counter){
+        static const char *names[NCOUNTER] = {"open", "read", "compute",
+                                              "cells",
+                                              "PopulateDatabaseMetaData",
+                                              "GetMesh", "GetVar",
+                                              "GetVectorVar",
+                                              "GetAuxiliaryData"};
+        return names[counter];
+    }
+
+    static double get_time(){
+#ifdef _WIN32
+        LARGE_INTEGER count;
+        LARGE_INTEGER frequency;
+        QueryPerformanceCounter(&count);
+        QueryPerformanceFrequency(&frequency);
+        return ((double)count.QuadPart)/frequency.QuadPart;
+#else
+        timeval tv;
+        gettimeofday(&tv, NULL);
+        return tv.tv_sec + 1.e-6*tv.tv_usec;
+#endif
+    }
+
+    class Timer{
+    private:
+        ReadStatistics &_statistics;
+        Counter _counter;
+        double _start;
+        // time spent in nested phases
+        double _nested;
+        Timer *_parent;
+
+    public:
+        Timer(ReadStatistics &statistics, Counter counter)
+            : _statistics(statistics), _counter(counter),
+              _start(get_time()), _nested(0.), _parent(NULL) {
+            if(_counter < POPULATE_METADATA){
+                _parent = _statistics._phase;
+                _statistics._phase = this;
+            }
+        }
+
+        ~Timer(){
+            double time = get_time() - _start;
+            if(_counter < POPULATE_METADATA){
+                _statistics._phase = _parent;
+                if(_parent){
+                    _parent->_nested += time;
+                }
+                time -= _nested;
+            }
+            _statistics.add(_counter, time);
+        }
+    };
+
+  private:
+    unsigned long long _ncall[NCOUNTER];
+    double _time[NCOUNTER];
+    unsigned long long _bytes[NCOUNTER];
+    // innermost running phase timer
+    Timer *_phase;
+    friend class Timer;
+    std::string _summary_filename;
+
+  public:
+    ReadStatistics() : _phase(NULL) {
+        reset();
+    }
+
+    // set the file the statistics are appended to (none if empty)
+    void set_summary_file(const std::string &filename){
+        _summary_filename = filename;
+    }
+
+    void reset(){
+        for(unsigned int i = 0; i < NCOUNTER; i++){
+            _ncall[i] = 0;
+            _time[i] = 0.;
+            _bytes[i] = 0;
+        }
+    }
+
+    void add(Counter counter, double time){
+        _ncall[counter]++;
+        _time[counter] += time;
+    }
+
+    void add_bytes(Counter counter, unsigned long long bytes){
+        _bytes[counter] += bytes;
+    }
+
+    bool empty() const {
+        for(unsigned int i = 0; i < NCOUNTER; i++){
+            if(_ncall[i]){
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void report(std::ostream &log, const std::string &plugin,
+                const std::string &snapshot){
+        if(empty()){
+            return;
+        }
+        std::stringstream summary;
+        log << "Read statistics for " << snapshot << ":" << std::endl;
+        for(unsigned int i = 0; i < NCOUNTER; i++){
+            if(!_ncall[i]){
+                continue;
+            }
+            const char *name = get_name((Counter)i);
+            log << "  " << name << ": " << _ncall[i] << " calls, "
+                << _time[i] << " s";
+            if(_bytes[i]){
+                log << ", " << _bytes[i] << " bytes";
+                if(_time[i] > 0.){
+                    log << " (" << _bytes[i]/(1048576.*_time[i]) << " MB/s)";
+                }
+            }
+            log << std::endl;
+            summary << plugin << "\t" << snapshot << "\t" << name << "\t"
+                    << _ncall[i] << "\t" << std::setprecision(9) << _time[i]
+                    << "\t" << _bytes[i] << "\n";
+        }
+        if(!_summary_filename.empty()){
+            // write all lines at once, other processes might append too
+            std::ofstream file(_summary_filename.c_str(),
+                               std::ios::out | std::ios::app);
+            file << summary.str();
+            file.flush();
+            if(!file.good()){
+                log << "Could not write read statistics to "
+                    << _summary_filename << std::endl;
+            }
+        }
+        reset();
+    }
+};
+
+#endif
@@ -0,0 +1,355 @@
+/*****************************************************************************
+*
+* Copyright (c) 2000 - 2013, Lawrence Livermore National Security, LLC
+* Produced at the Lawrence Livermore National Laboratory
+* LLNL-CODE-442911
+* All rights reserved.
+*
+* This file is  part of VisIt. For  details, see https://visit.llnl.gov/.  The
+* full copyright notice is contained in the file COPYRIGHT located at the root
+* of the VisIt distribution or at http://www.llnl.gov/visit/copyright.html.
+*
+* Redistribution  and  use  in  source  and  binary  forms,  with  or  without
+* modification, are permitted provided that the following conditions are met:
+*
+*  - Redistributions of  source code must  retain the above  copyright notice,
+*    this list of conditions and the disclaimer below.
+*  - Redistributions in binary form must reproduce the above copyright notice,
+*    this  list of  conditions  and  the  disclaimer (as noted below)  in  the
+*    documentation and/or other materials provided with the distribution.
+*  - Neither the name of  the LLNS/LLNL nor the names of  its contributors may
+*    be used to endorse or promote products derived from this software without
+*    specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT  HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR  IMPLIED WARRANTIES, INCLUDING,  BUT NOT  LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND  FITNESS FOR A PARTICULAR  PURPOSE
+* ARE  DISCLAIMED. IN  NO EVENT  SHALL LAWRENCE  LIVERMORE NATIONAL  SECURITY,
+* LLC, THE  U.S.  DEPARTMENT OF  ENERGY  OR  CONTRIBUTORS BE  LIABLE  FOR  ANY
+* DIRECT,  INDIRECT,   INCIDENTAL,   SPECIAL,   EXEMPLARY,  OR   CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT  LIMITED TO, PROCUREMENT OF  SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF  USE, DATA, OR PROFITS; OR  BUSINESS INTERRUPTION) HOWEVER
+* CAUSED  AND  ON  ANY  THEORY  OF  LIABILITY,  WHETHER  IN  CONTRACT,  STRICT
+* LIABILITY, OR TORT  (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY  WAY
+* OUT OF THE  USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+* DAMAGE.
+*
+*****************************************************************************/
+
+
+// ************************************************************************* //
+//                               SeriesIndex.h                               //
+// ************************************************************************* //
+
+#ifndef SERIES_INDEX_H
+#define SERIES_INDEX_H
+
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+
+#include <sys/stat.h>
+
+#include <SidecarFile.h>
+
+
+// ****************************************************************************
+//  Class: SeriesIndex
+//
+//  Purpose:
+//      Stores the metadata of all snapshots of a time series in a single
+//      index file in the directory of the snapshots, so that VisIt can get
+//      the time (and the other metadata) of every snapshot without opening
+//      it.
+//
+//  Programmer: Bert Vandenbroucke
+//  Creation:   Sat Oct 17 21:23:10 CEST 2026
+//
+//  The index file starts with an 8 character magic string and a version
+//  number, followed by a list of records. Every record contains the name of
+//  a snapshot (without the directory), its size and modification time, and
+//  the metadata the plugin stored for it (as a Record). A record is only
+//  used if the size and modification time of the snapshot still match.
+//  New records are appended to the index file, so that the index is filled
+//  incrementally as snapshots are opened for the first time, and the index
+//  is reread from where we stopped when another process appended to it.
+//  Later records for the same snapshot replace earlier ones. If the index
+//  contains too many outdated records, or if it is not a valid index file,
+//  it is rewritten (to a temporary file first, like a SidecarFile).
+//  The index is only read once per process: there is a single SeriesIndex
+//  per index file, obtained with get_index.
+//  As for sidecar files, writing silently fails if the directory is not
+//  writable, and all values are stored in native byte order.
+//
+// ****************************************************************************
+
+class SeriesIndex
+{
+  public:
+    // metadata of a single snapshot: a sequence of binary values
+    class Record{
+    private:
+        std::string _data;
+        unsigned long long _position;
+
+    public:
+        Record() : _position(0) {}
+        Record(const std::string &data) : _data(data), _position(0) {}
+
+        const std::string &get_data() const { return _data; }
+
+        template<typename T> void write(const T &value){
+            _data.append(reinterpret_cast<const char*>(&value), sizeof(T));
+        }
+
+        template<typename T> void write(const T *values,
+                                        unsigned long long n){
+            _data.append(reinterpret_cast<const char*>(values),
+                         n*sizeof(T));
+        }
+
+        void write(const std::string &value){
+            write((unsigned int)value.size());
+            _data.append(value);
+        }
+
+        // the read functions return false if the record is too short
+        template<typename T> bool read(T &value){
+            return read(&value, 1);
+        }
+
+        template<typename T> bool read(T *values, unsigned long long n){
+            if(_position + n*sizeof(T) > _data.size()){
+                return false;
+            }
+            memcpy(values, &_data[_position], n*sizeof(T));
+            _position += n*sizeof(T);
+            return true;
+        }
+
+        bool read(std::string &value){
+            unsigned int size;
+            if(!read(size) || _position + size > _data.size()){
+                return false;
+            }
+            value = _data.substr(_position, size);
+            _position += size;
+            return true;
+        }
+    };
+
+  private:
+    class Entry{
+    public:
+        unsigned long long _size;
+        long long _mtime;
+        std::string _data;
+    };
+
+    std::string _name;
+    char _magic[8];
+    unsigned int _version;
+    std::map<std::string, Entry> _entries;
+    // number of records in the index file
+    unsigned long long _nrecord;
+    // part of the index file that has been read, and its inode (which
+    // changes if the file is rewritten)
+    unsigned long long _loaded;
+    unsigned long long _inode;
+    // false if the index file does not exist or is not a valid index
+    bool _valid;
+
+    SeriesIndex(const std::string &name, const char *magic,
+                unsigned int version)
+        : _name(name), _version(version), _nrecord(0), _loaded(0),
+          _inode(0), _valid(false) {
+        memcpy(_magic, magic, 8);
+    }
+
+    static std::string get_basename(const std::string &snapshot){
+        std::string::size_type slash = snapshot.find_last_of("/\\");
+        if(slash == std::string::npos){
+            return snapshot;
+        }
+        return snapshot.substr(slash+1);
+    }
+
+    static void write_record(std::ostream &stream, const std::string &name,
+                             const Entry &entry){
+        Record record;
+        record.write(name);
+        record.write(entry._size);
+        record.write(entry._mtime);
+        record.write(entry._data);
+        unsigned int size = record.get_data().size();
+        stream.write(reinterpret_cast<const char*>(&size),
+                     sizeof(unsigned int));
+        stream.write(record.get_data().c_str(), size);
+    }
+
+    // read the records that were added to the index file since the last
+    // time we read it (or the complete file if it was rewritten)
+    void load(){
+        struct stat buffer;
+        if(stat(_name.c_str(), &buffer)){
+            _valid = false;
+            return;
+        }
+        if((unsigned long long)buffer.st_ino != _inode ||
+           (unsigned long long)buffer.st_size < _loaded){
+            _entries.clear();
+            _nrecord = 0;
+            _loaded = 0;
+            _inode = buffer.st_ino;
+        }
+        if((unsigned long long)buffer.st_size == _loaded){
+            return;
+        }
+        std::ifstream stream(_name.c_str(), std::ios::in | std::ios::binary);
+        if(!stream.is_open()){
+            return;
+        }
+        if(!_loaded){
+            char magic[8];
+            unsigned int version = 0;
+            stream.read(magic, 8);
+            stream.read(reinterpret_cast<char*>(&version),
+                        sizeof(unsigned int));
+            _valid = (stream.good() && !strncmp(magic, _magic, 8) &&
+                      version == _version);
+            if(!_valid){
+                return;
+            }
+            _loaded = 8 + sizeof(unsigned int);
+        }
+        stream.seekg(_loaded);
+        while(true){
+            unsigned int size = 0;
+            stream.read(reinterpret_cast<char*>(&size), sizeof(unsigned int));
+            std::string data(size, '\0');
+            if(size){
+                stream.read(&data[0], size);
+            }
+            if(!stream.good()){
+                // end of the file, or a record that is still being written
+                break;
+            }
+            _loaded += sizeof(unsigned int) + size;
+            Record record(data);
+            std::string name;
+            Entry entry;
+            if(record.read(name) && record.read(entry._size) &&
+               record.read(entry._mtime) && record.read(entry._data)){
+                _entries[name] = entry;
+                _nrecord++;
+            }
+        }
+    }
+
+    // rewrite the index file with only the current records
+    void rewrite(){
+        std::stringstream tmpname;
+        tmpname << _name << ".tmp." << SIDECAR_GETPID() << "."
+                << (unsigned long)time(NULL);
+        std::ofstream stream(tmpname.str().c_str(), std::ios::out |
+                             std::ios::binary | std::ios::trunc);
+        if(!stream.is_open()){
+            return;
+        }
+        stream.write(_magic, 8);
+        stream.write(reinterpret_cast<const char*>(&_version),
+                     sizeof(unsigned int));
+        std::map<std::string, Entry>::iterator it;
+        for(it = _entries.begin(); it != _entries.end(); ++it){
+            write_record(stream, it->first, it->second);
+        }
+        stream.close();
+        if(stream.fail() || rename(tmpname.str().c_str(), _name.c_str())){
+            remove(tmpname.str().c_str());
+            return;
+        }
+        // make sure the next load starts from scratch
+        _valid = false;
+        _inode = 0;
+        load();
+    }
+
+  public:
+    // get the index with the given file name in the directory of the given
+    // snapshot
+    static SeriesIndex &get_index(const std::string &snapshot,
+                                  const char *name, const char *magic,
+                                  unsigned int version){
+        static std::map<std::string, SeriesIndex*> indices;
+        std::string::size_type slash = snapshot.find_last_of("/\\");
+        std::string filename = name;
+        if(slash != std::string::npos){
+            filename = snapshot.substr(0, slash+1) + name;
+        }
+        std::map<std::string, SeriesIndex*>::iterator it =
+            indices.find(filename);
+        if(it == indices.end()){
+            it = indices.insert(std::make_pair(filename,
+                     new SeriesIndex(filename, magic, version))).first;
+        }
+        return *it->second;
+    }
+
+    // get the record for the given snapshot. Returns false if there is no
+    // record for the current version of the snapshot
+    bool get(const std::string &snapshot, Record &record){
+        unsigned long long size;
+        long long mtime;
+        if(!SidecarFile::get_snapshot_stat(snapshot, size, mtime)){
+            return false;
+        }
+        std::string name = get_basename(snapshot);
+        for(unsigned int attempt = 0; attempt < 2; attempt++){
+            std::map<std::string, Entry>::iterator it = _entries.find(name);
+            if(it != _entries.end() && it->second._size == size &&
+               it->second._mtime == mtime){
+                record = Record(it->second._data);
+                return true;
+            }
+            if(!attempt){
+                // another process might have added it
+                load();
+            }
+        }
+        return false;
+    }
+
+    // store the record for the given snapshot
+    void set(const std::string &snapshot, const Record &record){
+        Entry entry;
+        if(!SidecarFile::get_snapshot_stat(snapshot, entry._size,
+                                           entry._mtime)){
+            return;
+        }
+        entry._data = record.get_data();
+        std::string name = get_basename(snapshot);
+        load();
+        _entries[name] = entry;
+        if(!_valid || _nrecord > 2*_entries.size() + 64){
+            rewrite();
+            return;
+        }
+        // the record is written in a single write, so that records that
+        // are appended simultaneously by other processes are not mixed up
+        std::stringstream buffer;
+        write_record(buffer, name, entry);
+        std::ofstream stream(_name.c_str(), std::ios::out |
+                             std::ios::binary | std::ios::app);
+        stream.write(buffer.str().c_str(), buffer.str().size());
+        stream.close();
+        // read our own record (and those of other processes) back in
+        load();
+    }
+};
+
+
+#endif
@@ -0,0 +1,222 @@
+/*****************************************************************************
+*
+* Copyright (c) 2000 - 2013, Lawrence Livermore National Security, LLC
+* Produced at the Lawrence Livermore National Laboratory
+* LLNL-CODE-442911
+* All rights reserved.
+*
+* This file is  part of VisIt. For  details, see https://visit.llnl.gov/.  The
+* full copyright notice is contained in the file COPYRIGHT located at the root
+* of the VisIt distribution or at http://www.llnl.gov/visit/copyright.html.
+*
+* Redistribution  and  use  in  source  and  binary  forms,  with  or  without
+* modification, are permitted provided that the following conditions are met:
+*
+*  - Redistributions of  source code must  retain the above  copyright notice,
+*    this list of conditions and the disclaimer below.
+*  - Redistributions in binary form must reproduce the above copyright notice,
+*    this  list of  conditions  and  the  disclaimer (as noted below)  in  the
+*    documentation and/or other materials provided with the distribution.
+*  - Neither the name of  the LLNS/LLNL nor the names of  its contributors may
+*    be used to endorse or promote products derived from this software without
+*    specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT  HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR  IMPLIED WARRANTIES, INCLUDING,  BUT NOT  LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND  FITNESS FOR A PARTICULAR  PURPOSE
+* ARE  DISCLAIMED. IN  NO EVENT  SHALL LAWRENCE  LIVERMORE NATIONAL  SECURITY,
+* LLC, THE  U.S.  DEPARTMENT OF  ENERGY  OR  CONTRIBUTORS BE  LIABLE  FOR  ANY
+* DIRECT,  INDIRECT,   INCIDENTAL,   SPECIAL,   EXEMPLARY,  OR   CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT  LIMITED TO, PROCUREMENT OF  SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF  USE, DATA, OR PROFITS; OR  BUSINESS INTERRUPTION) HOWEVER
+* CAUSED  AND  ON  ANY  THEORY  OF  LIABILITY,  WHETHER  IN  CONTRACT,  STRICT
+* LIABILITY, OR TORT  (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY  WAY
+* OUT OF THE  USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+* DAMAGE.
+*
+*****************************************************************************/
+
+// ************************************************************************* //
+//                               SidecarFile.h                               //
+// ************************************************************************* //
+
+#ifndef SIDECAR_FILE_H
+#define SIDECAR_FILE_H
+
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include <sys/stat.h>
+#ifdef _WIN32
+#include <process.h>
+#define SIDECAR_GETPID _getpid
+#else
+#include <unistd.h>
+#define SIDECAR_GETPID getpid
+#endif
+
+
+// ****************************************************************************
+//  Class: SidecarFile
+//
+//  Purpose:
+//      Reads and writes the binary files in which the plugins store
+//      information about a snapshot that is expensive to recompute (e.g. a
+//      spatial index), next to the snapshot itself.
+//
+//  Programmer: Bert Vandenbroucke
+//  Creation:   Sat Oct 17 15:10:27 CEST 2026
+//
+//  A sidecar file starts with an 8 character magic string that identifies
+//  its contents, a version number, and the size and modification time of
+//  the snapshot it belongs to. A sidecar file is only used if all of these
+//  match, so that it is automatically ignored (and rewritten) if the
+//  snapshot changes or the format of the sidecar file changes.
+//  Sidecar files are written to a temporary file first and then renamed, so
+//  that other processes (e.g. the other ranks of a parallel engine) never
+//  see a partially written file. If the snapshot directory is not writable,
+//  writing silently fails and the information is recomputed every time.
+//  All values are stored in native byte order.
+//
+//  Modifications:
+//    Bert Vandenbroucke, Sat Oct 17 21:23:10 CEST 2026
+//    Made get_snapshot_stat public, for the SeriesIndex.
+//
+//    Bert Vandenbroucke, Sun Oct 18 01:14:29 CEST 2026
+//    Added tell(), so that the ParticleIndex can map the data it reads.
+//
+// ****************************************************************************
+
+class SidecarFile
+{
+  private:
+    std::string _snapshot;
+    std::string _name;
+    std::string _tmpname;
+    std::ifstream _istream;
+    std::ofstream _ostream;
+
+  public:
+    // get the size and modification time of the given snapshot
+    static bool get_snapshot_stat(const std::string &snapshot,
+                                  unsigned long long &size,
+                                  long long &mtime){
+        struct stat buffer;
+        if(stat(snapshot.c_str(), &buffer)){
+            return false;
+        }
+        size = buffer.st_size;
+        mtime = buffer.st_mtime;
+        return true;
+    }
+
+    SidecarFile(const std::string &snapshot, const char *extension)
+        : _snapshot(snapshot), _name(snapshot + extension) {}
+
+    ~SidecarFile(){
+        if(_ostream.is_open()){
+            // the file was never committed: throw it away
+            _ostream.close();
+            remove(_tmpname.c_str());
+        }
+    }
+
+    const std::string &get_name() const { return _name; }
+
+    // open the sidecar file for reading. Returns false if it does not exist
+    // or does not belong to the current version of the snapshot
+    bool open_read(const char *magic, unsigned int version){
+        unsigned long long size;
+        long long mtime;
+        if(!get_snapshot_stat(_snapshot, size, mtime)){
+            return false;
+        }
+        _istream.open(_name.c_str(), std::ios::in | std::ios::binary);
+        if(!_istream.is_open()){
+            return false;
+        }
+        char fmagic[8];
+        unsigned int fversion = 0;
+        unsigned long long fsize = 0;
+        long long fmtime = 0;
+        _istream.read(fmagic, 8);
+        read(fversion);
+        read(fsize);
+        read(fmtime);
+        if(!_istream.good() || strncmp(fmagic, magic, 8) ||
+           fversion != version || fsize != size || fmtime != mtime){
+            _istream.close();
+            return false;
+        }
+        return true;
+    }
+
+    // open a temporary file for writing and write the header
+    bool open_write(const char *magic, unsigned int version){
+        unsigned long long size;
+        long long mtime;
+        if(!get_snapshot_stat(_snapshot, size, mtime)){
+            return false;
+        }
+        std::stringstream tmpname;
+        tmpname << _name << ".tmp." << SIDECAR_GETPID() << "."
+                << (unsigned long)time(NULL);
+        _tmpname = tmpname.str();
+        _ostream.open(_tmpname.c_str(),
+                      std::ios::out | std::ios::binary | std::ios::trunc);
+        if(!_ostream.is_open()){
+            return false;
+        }
+        _ostream.write(magic, 8);
+        write(version);
+        write(size);
+        write(mtime);
+        return _ostream.good();
+    }
+
+    // finish writing and move the temporary file in place
+    bool commit(){
+        _ostream.close();
+        bool ok = !_ostream.fail();
+        if(ok){
+            ok = !rename(_tmpname.c_str(), _name.c_str());
+        }
+        if(!ok){
+            remove(_tmpname.c_str());
+        }
+        return ok;
+    }
+
+    // true if all reads so far succeeded
+    bool good(){
+        return _istream.good();
+    }
+
+    // offset in the file of the next value that will be read
+    unsigned long long tell(){
+        return (unsigned long long)_istream.tellg();
+    }
+
+    template<typename T> void read(T &value){
+        _istream.read(reinterpret_cast<char*>(&value), sizeof(T));
+    }
+
+    template<typename T> void read(T *values, unsigned long long n){
+        _istream.read(reinterpret_cast<char*>(values), n*sizeof(T));
+    }
+
+    template<typename T> void write(const T &value){
+        _ostream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    template<typename T> void write(const T *values, unsigned long long n){
+        _ostream.write(reinterpret_cast<const char*>(values), n*sizeof(T));
+    }
+};
+
+
+#endif
@@ -0,0 +1,325 @@
+/*****************************************************************************
+*
+* Copyright (c) 2000 - 2013, Lawrence Livermore National Security, LLC
+* Produced at the Lawrence Livermore National Laboratory
+* LLNL-CODE-442911
+* All rights reserved.
+*
+* This file is  part of VisIt. For  details, see https://visit.llnl.gov/.  The
+* full copyright notice is contained in the file COPYRIGHT located at the root
+* of the VisIt distribution or at http://www.llnl.gov/visit/copyright.html.
+*
+* Redistribution  and  use  in  source  and  binary  forms,  with  or  without
+* modification, are permitted provided that the following conditions are met:
+*
+*  - Redistributions of  source code must  retain the above  copyright notice,
+*    this list of conditions and the disclaimer below.
+*  - Redistributions in binary form must reproduce the above copyright notice,
+*    this  list of  conditions  and  the  disclaimer (as noted below)  in  the
+*    documentation and/or other materials provided with the distribution.
+*  - Neither the name of  the LLNS/LLNL nor the names of  its contributors may
+*    be used to endorse or promote products derived from this software without
+*    specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT  HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR  IMPLIED WARRANTIES, INCLUDING,  BUT NOT  LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND  FITNESS FOR A PARTICULAR  PURPOSE
+* ARE  DISCLAIMED. IN  NO EVENT  SHALL LAWRENCE  LIVERMORE NATIONAL  SECURITY,
+* LLC, THE  U.S.  DEPARTMENT OF  ENERGY  OR  CONTRIBUTORS BE  LIABLE  FOR  ANY
+* DIRECT,  INDIRECT,   INCIDENTAL,   SPECIAL,   EXEMPLARY,  OR   CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT  LIMITED TO, PROCUREMENT OF  SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF  USE, DATA, OR PROFITS; OR  BUSINESS INTERRUPTION) HOWEVER
+* CAUSED  AND  ON  ANY  THEORY  OF  LIABILITY,  WHETHER  IN  CONTRACT,  STRICT
+* LIABILITY, OR TORT  (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY  WAY
+* OUT OF THE  USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+* DAMAGE.
+*
+*****************************************************************************/
+
+// ************************************************************************* //
+//                               SpatialIndex.h                              //
+// ************************************************************************* //
+
+#ifndef SPATIAL_INDEX_H
+#define SPATIAL_INDEX_H
+
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <SidecarFile.h>
+
+
+// ****************************************************************************
+//  Class: SpatialIndex
+//
+//  Purpose:
+//      Divides the particles of a snapshot into spatially compact buckets
+//      that can be used as domains, so that VisIt only has to read the
+//      buckets that overlap with the region of interest.
+//
+//  Programmer: Bert Vandenbroucke
+//  Creation:   Sat Oct 17 15:10:27 CEST 2026
+//
+//  For every particle type, the particles are sorted along a Peano-Hilbert
+//  curve through the bounding box of the particles, and the sorted list is
+//  split in buckets with (almost) equal numbers of particles. For every
+//  bucket, we store its bounding box and the particles it contains, as a
+//  list of runs (offset, count) of consecutive particles in the snapshot.
+//  Snapshots that are already written in Peano-Hilbert order (like Gadget2
+//  snapshots) have few runs per bucket, but any order works.
+//  Building the index requires a full read of the coordinates, so the index
+//  is stored in a sidecar file next to the snapshot (see SidecarFile).
+//
+// ****************************************************************************
+
+class SpatialIndex
+{
+  public:
+    typedef std::pair<unsigned long long, unsigned long long> Run;
+    typedef std::vector<Run> RunList;
+
+    class Bucket{
+    public:
+        // xmin, xmax, ymin, ymax, zmin, zmax (the format VisIt expects)
+        double _box[6];
+        unsigned long long _npart;
+        RunList _runs;
+
+        Bucket() : _npart(0) {
+            // an empty bucket has an empty (inverted) bounding box
+            for(unsigned int i = 0; i < 3; i++){
+                _box[2*i] = 1.;
+                _box[2*i+1] = -1.;
+            }
+        }
+    };
+
+  private:
+    std::vector< std::vector<Bucket> > _buckets;
+
+    // number of bits per dimension of the Peano-Hilbert keys
+    static const unsigned int KEY_BITS = 21;
+
+    // Peano-Hilbert key of the given integer coordinates, using the
+    // algorithm of Skilling (2004, AIP Conference Proceedings 707, 381)
+    static unsigned long long get_key(unsigned int *X, unsigned int ndim){
+        unsigned int M = 1u << (KEY_BITS-1);
+        // inverse undo excess work
+        for(unsigned int Q = M; Q > 1; Q >>= 1){
+            unsigned int P = Q - 1;
+            for(unsigned int i = 0; i < ndim; i++){
+                if(X[i] & Q){
+                    X[0] ^= P;
+                } else {
+                    unsigned int t = (X[0] ^ X[i]) & P;
+                    X[0] ^= t;
+                    X[i] ^= t;
+                }
+            }
+        }
+        // Gray encode
+        for(unsigned int i = 1; i < ndim; i++){
+            X[i] ^= X[i-1];
+        }
+        unsigned int t = 0;
+        for(unsigned int Q = M; Q > 1; Q >>= 1){
+            if(X[ndim-1] & Q){
+                t ^= Q - 1;
+            }
+        }
+        for(unsigned int i = 0; i < ndim; i++){
+            X[i] ^= t;
+        }
+        // interleave the transposed bits
+        unsigned long long key = 0;
+        for(int b = KEY_BITS-1; b >= 0; b--){
+            for(unsigned int i = 0; i < ndim; i++){
+                key = (key << 1) | ((X[i] >> b) & 1);
+            }
+        }
+        return key;
+    }
+
+  public:
+    SpatialIndex() {}
+
+    void clear(){
+        _buckets.clear();
+    }
+
+    bool empty() const {
+        return _buckets.empty();
+    }
+
+    unsigned int get_number_of_buckets(unsigned int type) const {
+        return _buckets[type].size();
+    }
+
+    const Bucket &get_bucket(unsigned int type, unsigned int i) const {
+        return _buckets[type][i];
+    }
+
+    // set the number of particle types (removes all existing buckets)
+    void set_number_of_types(unsigned int ntype){
+        _buckets.clear();
+        _buckets.resize(ntype);
+    }
+
+    // divide the npart particles with the given (x, y, z) positions in
+    // nbucket buckets. For 2D snapshots, the z coordinate is ignored.
+    void build(unsigned int type, const float *positions,
+               unsigned long long npart, unsigned int ndim,
+               unsigned int nbucket){
+        std::vector<Bucket> &buckets = _buckets[type];
+        buckets.clear();
+        buckets.resize(nbucket);
+        if(!npart){
+            return;
+        }
+
+        double box[6];
+        for(unsigned int j = 0; j < 3; j++){
+            box[2*j] = positions[j];
+            box[2*j+1] = positions[j];
+        }
+        for(unsigned long long i = 0; i < npart; i++){
+            for(unsigned int j = 0; j < 3; j++){
+                box[2*j] = std::min(box[2*j], (double)positions[3*i+j]);
+                box[2*j+1] = std::max(box[2*j+1], (double)positions[3*i+j]);
+            }
+        }
+
+        // Peano-Hilbert keys on a (2^KEY_BITS)^ndim grid covering the box
+        double scale[3];
+        for(unsigned int j = 0; j < 3; j++){
+            double side = box[2*j+1] - box[2*j];
+            scale[j] = side > 0. ? ((1u << KEY_BITS) - 1)/side : 0.;
+        }
+        std::vector<Run> keys(npart);
+        long long nloop = npart;
+#pragma omp parallel for schedule(static)
+        for(long long i = 0; i < nloop; i++){
+            unsigned int X[3];
+            for(unsigned int j = 0; j < 3; j++){
+                X[j] = (positions[3*i+j] - box[2*j])*scale[j];
+            }
+            keys[i].first = get_key(X, ndim);
+            keys[i].second = i;
+        }
+        std::sort(keys.begin(), keys.end());
+
+        std::vector<unsigned long long> ids;
+        for(unsigned int b = 0; b < nbucket; b++){
+            unsigned long long begin = npart*b/nbucket;
+            unsigned long long end = npart*(b+1)/nbucket;
+            Bucket &bucket = buckets[b];
+            bucket._npart = end - begin;
+            if(!bucket._npart){
+                continue;
+            }
+            ids.resize(bucket._npart);
+            for(unsigned long long i = begin; i < end; i++){
+                ids[i-begin] = keys[i].second;
+            }
+            std::sort(ids.begin(), ids.end());
+            const float *x = &positions[3*ids[0]];
+            for(unsigned int j = 0; j < 3; j++){
+                bucket._box[2*j] = x[j];
+                bucket._box[2*j+1] = x[j];
+            }
+            bucket._runs.push_back(Run(ids[0], 0));
+            for(unsigned long long i = 0; i < ids.size(); i++){
+                Run &run = bucket._runs.back();
+                if(ids[i] != run.first + run.second){
+                    bucket._runs.push_back(Run(ids[i], 1));
+                } else {
+                    run.second++;
+                }
+                x = &positions[3*ids[i]];
+                for(unsigned int j = 0; j < 3; j++){
+                    bucket._box[2*j] = std::min(bucket._box[2*j],
+                                                (double)x[j]);
+                    bucket._box[2*j+1] = std::max(bucket._box[2*j+1],
+                                                  (double)x[j]);
+                }
+            }
+        }
+    }
+
+    // read the index from the sidecar file of the given snapshot
+    // returns false if there is no (valid) sidecar file, or if it does not
+    // have the requested number of buckets
+    bool read(const std::string &snapshot, unsigned int nbucket){
+        SidecarFile file(snapshot, ".phindex");
+        if(!file.open_read("PHINDEX ", 1)){
+            return false;
+        }
+        unsigned int ntype = 0;
+        file.read(ntype);
+        if(!file.good() || ntype == 0 || ntype > 64){
+            return false;
+        }
+        set_number_of_types(ntype);
+        for(unsigned int type = 0; type < ntype && file.good(); type++){
+            unsigned int nb = 0;
+            file.read(nb);
+            if(nb != nbucket){
+                break;
+            }
+            std::vector<Bucket> &buckets = _buckets[type];
+            buckets.resize(nb);
+            for(unsigned int b = 0; b < nb && file.good(); b++){
+                Bucket &bucket = buckets[b];
+                unsigned long long nrun = 0;
+                file.read(bucket._box, 6);
+                file.read(bucket._npart);
+                file.read(nrun);
+                if(nrun > bucket._npart){
+                    break;
+                }
+                bucket._runs.resize(nrun);
+                for(unsigned long long r = 0; r < nrun; r++){
+                    file.read(bucket._runs[r].first);
+                    file.read(bucket._runs[r].second);
+                }
+            }
+        }
+        if(!file.good() || _buckets.back().size() != nbucket){
+            clear();
+            return false;
+        }
+        return true;
+    }
+
+    // write the index to the sidecar file of the given snapshot
+    bool write(const std::string &snapshot){
+        SidecarFile file(snapshot, ".phindex");
+        if(!file.open_write("PHINDEX ", 1)){
+            return false;
+        }
+        unsigned int ntype = _buckets.size();
+        file.write(ntype);
+        for(unsigned int type = 0; type < ntype; type++){
+            const std::vector<Bucket> &buckets = _buckets[type];
+            unsigned int nb = buckets.size();
+            file.write(nb);
+            for(unsigned int b = 0; b < nb; b++){
+                const Bucket &bucket = buckets[b];
+                unsigned long long nrun = bucket._runs.size();
+                file.write(bucket._box, 6);
+                file.write(bucket._npart);
+                file.write(nrun);
+                for(unsigned long long r = 0; r < nrun; r++){
+                    file.write(bucket._runs[r].first);
+                    file.write(bucket._runs[r].second);
+                }
+            }
+        }
+        return file.commit();
+    }
+};
+
+
+#endif
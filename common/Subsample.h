@@ -0,0 +1,181 @@
+/*****************************************************************************
+*
+* Copyright (c) 2000 - 2013, Lawrence Livermore National Security, LLC
+* Produced at the Lawrence Livermore National Laboratory
+* LLNL-CODE-442911
+* All rights reserved.
+*
+* This file is  part of VisIt. For  details, see https://visit.llnl.gov/.  The
+* full copyright notice is contained in the file COPYRIGHT located at the root
+* of the VisIt distribution or at http://www.llnl.gov/visit/copyright.html.
+*
+* Redistribution  and  use  in  source  and  binary  forms,  with  or  without
+* modification, are permitted provided that the following conditions are met:
+*
+*  - Redistributions of  source code must  retain the above  copyright notice,
+*    this list of conditions and the disclaimer below.
+*  - Redistributions in binary form must reproduce the above copyright notice,
+*    this  list of  conditions  and  the  disclaimer (as noted below)  in  the
+*    documentation and/or other materials provided with the distribution.
+*  - Neither the name of  the LLNS/LLNL nor the names of  its contributors may
+*    be used to endorse or promote products derived from this software without
+*    specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT  HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR  IMPLIED WARRANTIES, INCLUDING,  BUT NOT  LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND  FITNESS FOR A PARTICULAR  PURPOSE
+* ARE  DISCLAIMED. IN  NO EVENT  SHALL LAWRENCE  LIVERMORE NATIONAL  SECURITY,
+* LLC, THE  U.S.  DEPARTMENT OF  ENERGY  OR  CONTRIBUTORS BE  LIABLE  FOR  ANY
+* DIRECT,  INDIRECT,   INCIDENTAL,   SPECIAL,   EXEMPLARY,  OR   CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT  LIMITED TO, PROCUREMENT OF  SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF  USE, DATA, OR PROFITS; OR  BUSINESS INTERRUPTION) HOWEVER
+* CAUSED  AND  ON  ANY  THEORY  OF  LIABILITY,  WHETHER  IN  CONTRACT,  STRICT
+* LIABILITY, OR TORT  (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY  WAY
+* OUT OF THE  USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+* DAMAGE.
+*
+*****************************************************************************/
+
+
+// ************************************************************************* //
+//                                Subsample.h                                //
+// ************************************************************************* //
+
+#ifndef SUBSAMPLE_H
+#define SUBSAMPLE_H
+
+#include <algorithm>
+#include <sstream>
+#include <string>
+#include <vector>
+
+
+// ****************************************************************************
+//  Class: Subsample
+//
+//  Purpose:
+//      Selects a reproducible fraction of the particles of a snapshot, so
+//      that a large snapshot can be previewed at a fraction of the cost of
+//      reading it completely.
+//
+//  Programmer: Bert Vandenbroucke
+//  Creation:   Sat Oct 17 16:48:19 CEST 2026
+//
+//  The particles are divided into strata of _stride consecutive particles
+//  (in the order in which they are stored in the snapshot), and we select
+//  one particle from every stratum: the first one for a fixed stride, or a
+//  pseudo-random one for a stratified random sample (which avoids aliasing
+//  if the particles are stored in a regular pattern). The selection only
+//  depends on the index of a particle, so the mesh and all variables use the
+//  same particles, independent of the domain that contains them.
+//  A fixed stride maps to a strided hyperslab (or strided positional reads)
+//  in the snapshot; a random sample needs a list of the selected indices.
+//
+// ****************************************************************************
+
+class Subsample
+{
+  private:
+    unsigned int _stride;
+    bool _random;
+
+    // reproducible pseudo-random number for the given stratum (the
+    // splitmix64 finalizer)
+    static unsigned long long get_hash(unsigned long long stratum){
+        unsigned long long z = stratum + 0x9e3779b97f4a7c15ULL;
+        z = (z ^ (z >> 30))*0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27))*0x94d049bb133111ebULL;
+        return z ^ (z >> 31);
+    }
+
+  public:
+    Subsample() : _stride(1), _random(false) {}
+
+    // select one in every stride particles (stride 1 selects everything)
+    void set(unsigned int stride, bool random){
+        _stride = std::max(stride, 1u);
+        _random = random && _stride > 1;
+    }
+
+    // false if all particles are selected
+    bool active() const {
+        return _stride > 1;
+    }
+
+    unsigned int get_stride() const {
+        return _stride;
+    }
+
+    bool is_random() const {
+        return _random;
+    }
+
+    // index of the selected particle in the given stratum
+    unsigned long long get_index(unsigned long long stratum) const {
+        unsigned long long index = stratum*_stride;
+        if(_random){
+            index += get_hash(stratum) % _stride;
+        }
+        return index;
+    }
+
+    // number of selected particles in [offset, offset+count[
+    unsigned long long get_count(unsigned long long offset,
+                                 unsigned long long count) const {
+        if(!count){
+            return 0;
+        }
+        unsigned long long end = offset + count;
+        unsigned long long first = offset/_stride;
+        unsigned long long last = (end-1)/_stride;
+        if(first == last){
+            unsigned long long index = get_index(first);
+            return (index >= offset && index < end);
+        }
+        return (last - first - 1) + (get_index(first) >= offset) +
+               (get_index(last) < end);
+    }
+
+    // number of selected particles in the given list of (offset, count) runs
+    template<typename RunList>
+    unsigned long long get_count(const RunList &runs) const {
+        unsigned long long count = 0;
+        for(unsigned int i = 0; i < runs.size(); i++){
+            count += get_count(runs[i].first, runs[i].second);
+        }
+        return count;
+    }
+
+    // first selected particle at or after offset (only for a fixed stride)
+    unsigned long long get_first(unsigned long long offset) const {
+        return (offset + _stride - 1)/_stride*_stride;
+    }
+
+    // append the indices of the selected particles in [offset, offset+count[
+    void add_indices(unsigned long long offset, unsigned long long count,
+                     std::vector<unsigned long long> &indices) const {
+        if(!count){
+            return;
+        }
+        unsigned long long end = offset + count;
+        for(unsigned long long s = offset/_stride; s <= (end-1)/_stride; s++){
+            unsigned long long index = get_index(s);
+            if(index >= offset && index < end){
+                indices.push_back(index);
+            }
+        }
+    }
+
+    // short description, used to tag data that depends on the sample
+    std::string get_description() const {
+        if(!active()){
+            return "";
+        }
+        std::stringstream description;
+        description << (_random ? " random " : " stride ") << _stride;
+        return description.str();
+    }
+};
+
+
+#endif
@@ -0,0 +1,142 @@
+/*****************************************************************************
+*
+* Copyright (c) 2000 - 2013, Lawrence Livermore National Security, LLC
+* Produced at the Lawrence Livermore National Laboratory
+* LLNL-CODE-442911
+* All rights reserved.
+*
+* This file is  part of VisIt. For  details, see https://visit.llnl.gov/.  The
+* full copyright notice is contained in the file COPYRIGHT located at the root
+* of the VisIt distribution or at http://www.llnl.gov/visit/copyright.html.
+*
+* Redistribution  and  use  in  source  and  binary  forms,  with  or  without
+* modification, are permitted provided that the following conditions are met:
+*
+*  - Redistributions of  source code must  retain the above  copyright notice,
+*    this list of conditions and the disclaimer below.
+*  - Redistributions in binary form must reproduce the above copyright notice,
+*    this  list of  conditions  and  the  disclaimer (as noted below)  in  the
+*    documentation and/or other materials provided with the distribution.
+*  - Neither the name of  the LLNS/LLNL nor the names of  its contributors may
+*    be used to endorse or promote products derived from this software without
+*    specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT  HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR  IMPLIED WARRANTIES, INCLUDING,  BUT NOT  LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND  FITNESS FOR A PARTICULAR  PURPOSE
+* ARE  DISCLAIMED. IN  NO EVENT  SHALL LAWRENCE  LIVERMORE NATIONAL  SECURITY,
+* LLC, THE  U.S.  DEPARTMENT OF  ENERGY  OR  CONTRIBUTORS BE  LIABLE  FOR  ANY
+* DIRECT,  INDIRECT,   INCIDENTAL,   SPECIAL,   EXEMPLARY,  OR   CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT  LIMITED TO, PROCUREMENT OF  SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF  USE, DATA, OR PROFITS; OR  BUSINESS INTERRUPTION) HOWEVER
+* CAUSED  AND  ON  ANY  THEORY  OF  LIABILITY,  WHETHER  IN  CONTRACT,  STRICT
+* LIABILITY, OR TORT  (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY  WAY
+* OUT OF THE  USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+* DAMAGE.
+*
+*****************************************************************************/
+
+// ************************************************************************* //
+//                             VertexCellCache.h                             //
+// ************************************************************************* //
+
+#ifndef VERTEX_CELL_CACHE_H
+#define VERTEX_CELL_CACHE_H
+
+#include <map>
+
+#include <vtkCellArray.h>
+#include <vtkCellType.h>
+#include <vtkIdTypeArray.h>
+#include <vtkUnsignedCharArray.h>
+#include <vtkUnstructuredGrid.h>
+
+
+// ****************************************************************************
+//  Class: VertexCellCache
+//
+//  Purpose:
+//      Sets up the vertex cells of a particle mesh in bulk.
+//
+//  Programmer: Bert Vandenbroucke
+//  Creation:   Sat Oct 17 14:02:33 CEST 2026
+//
+//  A particle mesh has one VTK_VERTEX cell per particle. Inserting these one
+//  at a time with vtkUnstructuredGrid::InsertNextCell is slower than reading
+//  the particles from the file. Instead, we fill the connectivity, cell
+//  location and cell type arrays directly (in parallel, if OpenMP is
+//  enabled) and hand them to the grid in one go.
+//  The cell arrays only depend on the number of particles, so we keep them
+//  around and reuse them for every mesh with the same number of particles
+//  until clear() is called (from FreeUpResources). VTK reference counts the
+//  arrays, so they stay valid for grids that outlive the cache.
+//
+// ****************************************************************************
+
+class VertexCellCache
+{
+  private:
+    class VertexCells{
+    public:
+        vtkUnsignedCharArray *_types;
+        vtkIdTypeArray *_locations;
+        vtkCellArray *_cells;
+
+        VertexCells(vtkIdType npart){
+            _types = vtkUnsignedCharArray::New();
+            _types->SetNumberOfValues(npart);
+            _locations = vtkIdTypeArray::New();
+            _locations->SetNumberOfValues(npart);
+            vtkIdTypeArray *connectivity = vtkIdTypeArray::New();
+            connectivity->SetNumberOfValues(2*npart);
+
+            unsigned char *types = _types->GetPointer(0);
+            vtkIdType *locations = _locations->GetPointer(0);
+            vtkIdType *ids = connectivity->GetPointer(0);
+#pragma omp parallel for schedule(static)
+            for(vtkIdType i = 0; i < npart; i++){
+                types[i] = VTK_VERTEX;
+                locations[i] = 2*i;
+                ids[2*i] = 1;
+                ids[2*i+1] = i;
+            }
+
+            _cells = vtkCellArray::New();
+            _cells->SetCells(npart, connectivity);
+            connectivity->Delete();
+        }
+
+        void release(){
+            _types->Delete();
+            _locations->Delete();
+            _cells->Delete();
+        }
+    };
+
+    std::map<vtkIdType, VertexCells> _cache;
+
+  public:
+    VertexCellCache() {}
+    ~VertexCellCache() { clear(); }
+
+    // give the grid one vertex cell for each of its npart points
+    void set_cells(vtkUnstructuredGrid *ugrid, vtkIdType npart){
+        std::map<vtkIdType, VertexCells>::iterator it = _cache.find(npart);
+        if(it == _cache.end()){
+            it = _cache.insert(std::make_pair(npart, VertexCells(npart))).first;
+        }
+        ugrid->SetCells(it->second._types, it->second._locations,
+                        it->second._cells);
+    }
+
+    void clear(){
+        std::map<vtkIdType, VertexCells>::iterator it;
+        for(it = _cache.begin(); it != _cache.end(); ++it){
+            it->second.release();
+        }
+        _cache.clear();
+    }
+};
+
+
+#endif
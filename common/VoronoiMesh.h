@@ -0,0 +1,825 @@
+/*****************************************************************************
+*
+* Copyright (c) 2000 - 2013, Lawrence Livermore National Security, LLC
+* Produced at the Lawrence Livermore National Laboratory
+* LLNL-CODE-442911
+* All rights reserved.
+*
+* This file is  part of VisIt. For  details, see https://visit.llnl.gov/.  The
+* full copyright notice is contained in the file COPYRIGHT located at the root
+* of the VisIt distribution or at http://www.llnl.gov/visit/copyright.html.
+*
+* Redistribution  and  use  in  source  and  binary  forms,  with  or  without
+* modification, are permitted provided that the following conditions are met:
+*
+*  - Redistributions of  source code must  retain the above  copyright notice,
+*    this list of conditions and the disclaimer below.
+*  - Redistributions in binary form must reproduce the above copyright notice,
+*    this  list of  conditions  and  the  disclaimer (as noted below)  in  the
+*    documentation and/or other materials provided with the distribution.
+*  - Neither the name of  the LLNS/LLNL nor the names of  its contributors may
+*    be used to endorse or promote products derived from this software without
+*    specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT  HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR  IMPLIED WARRANTIES, INCLUDING,  BUT NOT  LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND  FITNESS FOR A PARTICULAR  PURPOSE
+* ARE  DISCLAIMED. IN  NO EVENT  SHALL LAWRENCE  LIVERMORE NATIONAL  SECURITY,
+* LLC, THE  U.S.  DEPARTMENT OF  ENERGY  OR  CONTRIBUTORS BE  LIABLE  FOR  ANY
+* DIRECT,  INDIRECT,   INCIDENTAL,   SPECIAL,   EXEMPLARY,  OR   CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT  LIMITED TO, PROCUREMENT OF  SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF  USE, DATA, OR PROFITS; OR  BUSINESS INTERRUPTION) HOWEVER
+* CAUSED  AND  ON  ANY  THEORY  OF  LIABILITY,  WHETHER  IN  CONTRACT,  STRICT
+* LIABILITY, OR TORT  (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY  WAY
+* OUT OF THE  USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+* DAMAGE.
+*
+*****************************************************************************/
+
+
+
+
+// ************************************************************************* //
+//                               VoronoiMesh.h                               //
+// ************************************************************************* //
+
+#ifndef VORONOI_MESH_H
+#define VORONOI_MESH_H
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include <vector>
+
+#include <vtkCellArray.h>
+#include <vtkCellType.h>
+#include <vtkIdTypeArray.h>
+#include <vtkPoints.h>
+#include <vtkUnsignedCharArray.h>
+#include <vtkUnstructuredGrid.h>
+
+
+// ****************************************************************************
+//  Class: VoronoiMesh
+//
+//  Purpose:
+//      Reconstructs the Voronoi cells of a set of generators (the mesh of a
+//      moving-mesh code), so that cell variables can be plotted on the cells
+//      they represent instead of on their generators.
+//
+//  Programmer: Bert Vandenbroucke
+//  Creation:   Sun Oct 18 03:12:08 CEST 2026
+//
+//  Every cell is constructed independently: we start from the bounding box
+//  of the generators and cut it with the bisector planes (lines in 2D) of
+//  the other generators, in order of increasing distance, until the next
+//  candidates are further away than twice the distance to the farthest
+//  vertex of the cell, so that they can no longer cut it. The candidates are
+//  found with a uniform grid of bins that holds about two generators per
+//  bin, searched in shells of bins around the generator.
+//  Since cells do not depend on each other, the cells are constructed in
+//  parallel (with OpenMP), in blocks of generators that are consecutive in
+//  the bin order: the generators of a block are close together, so that
+//  they mostly look at the same bins. The cells stay in the buffers of the
+//  block that constructed them (no copy to a single array is needed), and
+//  are put in the order of the generators when the VTK mesh is made.
+//  Vertices are not shared between cells: every cell stores its own
+//  vertices, and in 3D its faces as loops of (cell) vertex indices,
+//  counterclockwise when seen from outside the cell. Vertices that are
+//  within a small distance of a bisector are considered to be on it, so that
+//  degenerate generator sets (like Cartesian lattices) do not produce
+//  slivers.
+//
+//  Modifications:
+//    Bert Vandenbroucke, Sun Oct 18 05:31:40 CEST 2026
+//    Only construct the cells of the first generators that are passed on to
+//    build; the other generators are only used as neighbours, so that a
+//    domain can be built from its own generators and a halo of generators
+//    around it. The cells are clipped to a given box, which can be larger
+//    than the generators, and get_reach returns the region in which the
+//    neighbours of the cells have to be for the cells to be exact.
+//
+// ****************************************************************************
+
+class VoronoiMesh
+{
+  private:
+    // the cell that is being constructed, with scratch space that is reused
+    // for every cell constructed by the same thread
+    class Cell{
+    public:
+        // vertices relative to the generator, 3 coordinates per vertex (z is
+        // 0 in 2D); in 2D, they are in counterclockwise order
+        std::vector<double> _vertices;
+        // 3D faces as [n, v0 ... vn-1]
+        std::vector<int> _faces;
+        // squared distance from the generator to the farthest vertex
+        double _r2;
+
+        std::vector<double> _side;
+        std::vector<double> _newvertices;
+        std::vector<int> _newfaces;
+        std::vector<int> _edges;
+        std::vector<int> _remap;
+        std::vector< std::pair<double, int> > _cap;
+    };
+
+    // uniform grid of bins, with the generators sorted on bin index
+    class BinGrid{
+    public:
+        unsigned int _ndim;
+        double _lo[3];
+        double _width[3];
+        long long _nbin[3];
+        // the generators in bin b are [_start[b], _start[b+1]) in the
+        // sorted order
+        std::vector<unsigned long long> _start;
+        // positions (3 per generator) and original index, in sorted order
+        std::vector<double> _positions;
+        std::vector<unsigned long long> _index;
+
+        void get_bin(const double *x, long long *b) const {
+            for(unsigned int k = 0; k < 3; k++){
+                b[k] = (long long)((x[k] - _lo[k])/_width[k]);
+                b[k] = std::max(0LL, std::min(b[k], _nbin[k] - 1));
+            }
+        }
+
+        void build(const float *positions, unsigned long long n,
+                   unsigned int ndim, const double *lo, const double *hi){
+            _ndim = ndim;
+            double volume = 1.;
+            for(unsigned int k = 0; k < ndim; k++){
+                volume *= hi[k] - lo[k];
+            }
+            // about 2 generators per bin
+            double width = std::pow(2.*volume/n, 1./ndim);
+            unsigned long long nbin = 1;
+            for(unsigned int k = 0; k < 3; k++){
+                _lo[k] = k < ndim ? lo[k] : 0.;
+                _nbin[k] = 1;
+                if(k < ndim){
+                    _nbin[k] = (long long)((hi[k] - lo[k])/width);
+                    _nbin[k] = std::max(1LL, std::min(_nbin[k], 1LL << 20));
+                }
+                _width[k] = k < ndim ? (hi[k] - lo[k])/_nbin[k] : 1.;
+                nbin *= _nbin[k];
+            }
+
+            // counting sort on bin index
+            std::vector<unsigned long long> bins(n);
+            long long nloop = n;
+#pragma omp parallel for schedule(static)
+            for(long long i = 0; i < nloop; i++){
+                double x[3];
+                long long b[3];
+                for(unsigned int k = 0; k < 3; k++){
+                    x[k] = k < ndim ? positions[3*i+k] : 0.;
+                }
+                get_bin(x, b);
+                bins[i] = (b[2]*_nbin[1] + b[1])*_nbin[0] + b[0];
+            }
+            _start.assign(nbin + 1, 0);
+            for(unsigned long long i = 0; i < n; i++){
+                _start[bins[i]+1]++;
+            }
+            for(unsigned long long b = 0; b < nbin; b++){
+                _start[b+1] += _start[b];
+            }
+            std::vector<unsigned long long> next(_start.begin(),
+                                                 _start.end() - 1);
+            _positions.resize(3*n);
+            _index.resize(n);
+            for(unsigned long long i = 0; i < n; i++){
+                unsigned long long j = next[bins[i]]++;
+                for(unsigned int k = 0; k < 3; k++){
+                    _positions[3*j+k] = k < ndim ? positions[3*i+k] : 0.;
+                }
+                _index[j] = i;
+            }
+        }
+    };
+
+    // cells of a block of generators that are consecutive in the sorted
+    // order
+    class Block{
+    public:
+        // 3 coordinates per vertex
+        std::vector<float> _vertices;
+        // 3D: per cell [nface, n0, ids..., n1, ids...], with cell vertex ids
+        std::vector<int> _faces;
+    };
+
+    static const unsigned int BLOCK_SIZE = 4096;
+
+    bool _built;
+    unsigned int _ndim;
+    // region that contains all generators that can cut the cells
+    double _reach[6];
+    std::vector<Block> _blocks;
+    // per generator: its index in the sorted order
+    std::vector<unsigned long long> _sorted;
+    // per sorted generator: the number of vertices and face elements of its
+    // cell, and where they start in the buffers of its block
+    std::vector<unsigned int> _nvertex;
+    std::vector<unsigned int> _nface;
+    std::vector<unsigned int> _vertex_start;
+    std::vector<unsigned int> _face_start;
+
+    static void update_radius(Cell &cell){
+        cell._r2 = 0.;
+        const std::vector<double> &x = cell._vertices;
+        for(unsigned int i = 0; i < x.size(); i += 3){
+            cell._r2 = std::max(cell._r2,
+                                x[i]*x[i] + x[i+1]*x[i+1] + x[i+2]*x[i+2]);
+        }
+    }
+
+    // initialize the cell to the box [lo, hi] around generator x
+    static void init_cell(Cell &cell, unsigned int ndim, const double *x,
+                          const double *lo, const double *hi){
+        double a[3], b[3];
+        for(unsigned int k = 0; k < 3; k++){
+            a[k] = k < ndim ? lo[k] - x[k] : 0.;
+            b[k] = k < ndim ? hi[k] - x[k] : 0.;
+        }
+        cell._vertices.clear();
+        cell._faces.clear();
+        if(ndim == 2){
+            double square[12] = {a[0], a[1], 0., b[0], a[1], 0.,
+                                 b[0], b[1], 0., a[0], b[1], 0.};
+            cell._vertices.assign(square, square + 12);
+        } else {
+            for(unsigned int v = 0; v < 8; v++){
+                cell._vertices.push_back((v & 1) ? b[0] : a[0]);
+                cell._vertices.push_back((v & 2) ? b[1] : a[1]);
+                cell._vertices.push_back((v & 4) ? b[2] : a[2]);
+            }
+            static const int box[30] = {4, 0, 4, 6, 2, 4, 1, 3, 7, 5,
+                                        4, 0, 1, 5, 4, 4, 2, 6, 7, 3,
+                                        4, 0, 2, 3, 1, 4, 4, 5, 7, 6};
+            cell._faces.assign(box, box + 30);
+        }
+        update_radius(cell);
+    }
+
+    // signed distances of the vertices to the bisector with a generator at
+    // u (relative to the cell generator), returns false if no vertex is
+    // above it
+    static bool get_sides(Cell &cell, const double *u, double eps){
+        double norm = std::sqrt(u[0]*u[0] + u[1]*u[1] + u[2]*u[2]);
+        double h = 0.5*norm;
+        const std::vector<double> &x = cell._vertices;
+        unsigned int nvertex = x.size()/3;
+        cell._side.resize(nvertex);
+        bool above = false;
+        for(unsigned int i = 0; i < nvertex; i++){
+            double s = (u[0]*x[3*i] + u[1]*x[3*i+1] + u[2]*x[3*i+2])/norm - h;
+            cell._side[i] = s;
+            above |= s > eps;
+        }
+        return above;
+    }
+
+    // intersection of the edge (a, b) with the bisector, shared between the
+    // two faces of the edge
+    static int intersect(Cell &cell, int a, int b){
+        int first = std::min(a, b);
+        int second = std::max(a, b);
+        for(unsigned int i = 0; i < cell._edges.size(); i += 3){
+            if(cell._edges[i] == first && cell._edges[i+1] == second){
+                return cell._edges[i+2];
+            }
+        }
+        double sa = cell._side[a];
+        double t = sa/(sa - cell._side[b]);
+        double x[3];
+        for(unsigned int k = 0; k < 3; k++){
+            double xa = cell._vertices[3*a+k];
+            x[k] = xa + t*(cell._vertices[3*b+k] - xa);
+        }
+        int v = cell._vertices.size()/3;
+        cell._vertices.insert(cell._vertices.end(), x, x + 3);
+        cell._side.push_back(0.);
+        cell._edges.push_back(first);
+        cell._edges.push_back(second);
+        cell._edges.push_back(v);
+        return v;
+    }
+
+    // cut off the part of a 2D cell above the bisector
+    static void clip2d(Cell &cell, const double *u, double eps){
+        if(!get_sides(cell, u, eps)){
+            return;
+        }
+        const std::vector<double> &x = cell._vertices;
+        const std::vector<double> &side = cell._side;
+        unsigned int nvertex = x.size()/3;
+        cell._newvertices.clear();
+        for(unsigned int a = 0; a < nvertex; a++){
+            unsigned int b = (a + 1)%nvertex;
+            if(side[a] <= eps){
+                cell._newvertices.insert(cell._newvertices.end(), &x[3*a],
+                                         &x[3*a] + 3);
+            }
+            if((side[a] > eps && side[b] < -eps) ||
+               (side[a] < -eps && side[b] > eps)){
+                double t = side[a]/(side[a] - side[b]);
+                for(unsigned int k = 0; k < 3; k++){
+                    cell._newvertices.push_back(x[3*a+k] +
+                                                t*(x[3*b+k] - x[3*a+k]));
+                }
+            }
+        }
+        cell._vertices.swap(cell._newvertices);
+        update_radius(cell);
+    }
+
+    // cut off the part of a 3D cell above the bisector
+    static void clip3d(Cell &cell, const double *u, double eps){
+        if(!get_sides(cell, u, eps)){
+            return;
+        }
+        cell._edges.clear();
+        cell._newfaces.clear();
+        // clip the faces, the faces that are entirely above disappear
+        for(unsigned int i = 0; i < cell._faces.size();
+            i += cell._faces[i] + 1){
+            int n = cell._faces[i];
+            const int *face = &cell._faces[i+1];
+            unsigned int start = cell._newfaces.size();
+            cell._newfaces.push_back(0);
+            for(int j = 0; j < n; j++){
+                int a = face[j];
+                int b = face[(j + 1)%n];
+                double sa = cell._side[a];
+                double sb = cell._side[b];
+                if(sa <= eps){
+                    cell._newfaces.push_back(a);
+                }
+                if((sa > eps && sb < -eps) || (sa < -eps && sb > eps)){
+                    cell._newfaces.push_back(intersect(cell, a, b));
+                }
+            }
+            int count = cell._newfaces.size() - start - 1;
+            if(count < 3){
+                cell._newfaces.resize(start);
+            } else {
+                cell._newfaces[start] = count;
+            }
+        }
+
+        // the new face consists of all vertices on the bisector, sorted
+        // counterclockwise around u
+        unsigned int nvertex = cell._vertices.size()/3;
+        const std::vector<double> &x = cell._vertices;
+        double center[3] = {0., 0., 0.};
+        cell._cap.clear();
+        for(unsigned int i = 0; i < nvertex; i++){
+            if(std::abs(cell._side[i]) <= eps){
+                cell._cap.push_back(std::make_pair(0., (int)i));
+                for(unsigned int k = 0; k < 3; k++){
+                    center[k] += x[3*i+k];
+                }
+            }
+        }
+        unsigned int ncap = cell._cap.size();
+        if(ncap >= 3){
+            double e1[3] = {0., 0., 0.};
+            double l1 = 0.;
+            for(unsigned int k = 0; k < 3; k++){
+                center[k] /= ncap;
+            }
+            for(unsigned int i = 0; i < ncap; i++){
+                const double *v = &x[3*cell._cap[i].second];
+                double d[3] = {v[0] - center[0], v[1] - center[1],
+                               v[2] - center[2]};
+                double l = d[0]*d[0] + d[1]*d[1] + d[2]*d[2];
+                if(l > l1){
+                    l1 = l;
+                    std::copy(d, d + 3, e1);
+                }
+            }
+            // e2 = u x e1
+            double e2[3] = {u[1]*e1[2] - u[2]*e1[1], u[2]*e1[0] - u[0]*e1[2],
+                            u[0]*e1[1] - u[1]*e1[0]};
+            if(l1 > eps*eps){
+                for(unsigned int i = 0; i < ncap; i++){
+                    const double *v = &x[3*cell._cap[i].second];
+                    double d[3] = {v[0] - center[0], v[1] - center[1],
+                                   v[2] - center[2]};
+                    cell._cap[i].first =
+                        std::atan2(d[0]*e2[0] + d[1]*e2[1] + d[2]*e2[2],
+                                   d[0]*e1[0] + d[1]*e1[1] + d[2]*e1[2]);
+                }
+                std::sort(cell._cap.begin(), cell._cap.end());
+                cell._newfaces.push_back(ncap);
+                for(unsigned int i = 0; i < ncap; i++){
+                    cell._newfaces.push_back(cell._cap[i].second);
+                }
+            }
+        }
+
+        // remove the vertices that are no longer used
+        std::vector<int> &remap = cell._remap;
+        remap.assign(nvertex, -1);
+        for(unsigned int i = 0; i < cell._newfaces.size();
+            i += cell._newfaces[i] + 1){
+            for(int j = 0; j < cell._newfaces[i]; j++){
+                remap[cell._newfaces[i+1+j]] = 0;
+            }
+        }
+        int nkept = 0;
+        for(unsigned int i = 0; i < nvertex; i++){
+            if(!remap[i]){
+                for(unsigned int k = 0; k < 3; k++){
+                    cell._vertices[3*nkept+k] = cell._vertices[3*i+k];
+                }
+                remap[i] = nkept;
+                nkept++;
+            }
+        }
+        cell._vertices.resize(3*nkept);
+        for(unsigned int i = 0; i < cell._newfaces.size();
+            i += cell._newfaces[i] + 1){
+            for(int j = 0; j < cell._newfaces[i]; j++){
+                cell._newfaces[i+1+j] = remap[cell._newfaces[i+1+j]];
+            }
+        }
+        cell._faces.swap(cell._newfaces);
+        update_radius(cell);
+    }
+
+    // construct the cell of the generator with the given sorted index
+    static void construct(const BinGrid &grid, unsigned long long i,
+                          const double *lo, const double *hi, double eps,
+                          Cell &cell,
+                          std::vector< std::pair<double,
+                                                 unsigned long long> > &
+                              candidates){
+        unsigned int ndim = grid._ndim;
+        const double *x = &grid._positions[3*i];
+        init_cell(cell, ndim, x, lo, hi);
+        long long b[3];
+        grid.get_bin(x, b);
+        long long smax = 0;
+        for(unsigned int k = 0; k < ndim; k++){
+            smax = std::max(smax, std::max(b[k], grid._nbin[k] - 1 - b[k]));
+        }
+        for(long long s = 0; s <= smax; s++){
+            // neighbours in the bins at distance s (in bins)
+            candidates.clear();
+            long long sz = ndim == 3 ? s : 0;
+            for(long long dz = -sz; dz <= sz; dz++){
+                long long bz = b[2] + dz;
+                if(bz < 0 || bz >= grid._nbin[2]){
+                    continue;
+                }
+                for(long long dy = -s; dy <= s; dy++){
+                    long long by = b[1] + dy;
+                    if(by < 0 || by >= grid._nbin[1]){
+                        continue;
+                    }
+                    bool inner = s > 0 && std::abs(dy) < s &&
+                                 (ndim == 2 || std::abs(dz) < s);
+                    long long step = inner ? 2*s : 1;
+                    for(long long dx = -s; dx <= s; dx += step){
+                        long long bx = b[0] + dx;
+                        if(bx < 0 || bx >= grid._nbin[0]){
+                            continue;
+                        }
+                        long long bin = (bz*grid._nbin[1] + by)*grid._nbin[0] +
+                                        bx;
+                        for(unsigned long long j = grid._start[bin];
+                            j < grid._start[bin+1]; j++){
+                            const double *y = &grid._positions[3*j];
+                            double d2 = (y[0] - x[0])*(y[0] - x[0]) +
+                                        (y[1] - x[1])*(y[1] - x[1]) +
+                                        (y[2] - x[2])*(y[2] - x[2]);
+                            // only generators within twice the radius of
+                            // the cell can cut it
+                            if(j != i && d2 > 0. && d2 < 4.*cell._r2){
+                                candidates.push_back(std::make_pair(d2, j));
+                            }
+                        }
+                    }
+                }
+            }
+            std::sort(candidates.begin(), candidates.end());
+            for(unsigned int c = 0; c < candidates.size(); c++){
+                if(candidates[c].first >= 4.*cell._r2){
+                    break;
+                }
+                const double *y = &grid._positions[3*candidates[c].second];
+                double u[3] = {y[0] - x[0], y[1] - x[1], y[2] - x[2]};
+                if(ndim == 2){
+                    clip2d(cell, u, eps);
+                } else {
+                    clip3d(cell, u, eps);
+                }
+            }
+
+            // distance to the nearest bin at distance s+1
+            double dmin2 = -1.;
+            for(unsigned int k = 0; k < ndim; k++){
+                if(b[k] - s > 0){
+                    double d = x[k] - grid._lo[k] - (b[k] - s)*grid._width[k];
+                    dmin2 = dmin2 < 0. ? d*d : std::min(dmin2, d*d);
+                }
+                if(b[k] + s + 1 < grid._nbin[k]){
+                    double d = grid._lo[k] + (b[k] + s + 1)*grid._width[k] -
+                               x[k];
+                    dmin2 = dmin2 < 0. ? d*d : std::min(dmin2, d*d);
+                }
+            }
+            if(dmin2 >= 4.*cell._r2){
+                break;
+            }
+        }
+    }
+
+  public:
+    VoronoiMesh() : _built(false), _ndim(0) {
+        for(unsigned int k = 0; k < 3; k++){
+            _reach[2*k] = 1.;
+            _reach[2*k+1] = -1.;
+        }
+    }
+
+    bool empty() const {
+        return !_built;
+    }
+
+    void clear(){
+        _built = false;
+        std::vector<Block>().swap(_blocks);
+        std::vector<unsigned long long>().swap(_sorted);
+        std::vector<unsigned int>().swap(_nvertex);
+        std::vector<unsigned int>().swap(_nface);
+        std::vector<unsigned int>().swap(_vertex_start);
+        std::vector<unsigned int>().swap(_face_start);
+    }
+
+    unsigned long long get_number_of_cells() const {
+        return _sorted.size();
+    }
+
+    // the region (xmin, xmax, ymin, ymax, zmin, zmax) that contains all
+    // generators that can cut the cells of the last build: the cells are
+    // exact if all generators in this region were passed on to build
+    void get_reach(double *reach) const {
+        std::copy(_reach, _reach + 6, reach);
+    }
+
+    // grow the box [lo, hi] so that it contains the n given positions (3 per
+    // position, z is ignored in 2D)
+    static void add_to_box(const float *positions, unsigned long long n,
+                           unsigned int ndim, double *lo, double *hi){
+        for(unsigned long long i = 0; i < n; i++){
+            for(unsigned int k = 0; k < ndim; k++){
+                lo[k] = std::min(lo[k], (double)positions[3*i+k]);
+                hi[k] = std::max(hi[k], (double)positions[3*i+k]);
+            }
+        }
+    }
+
+    // half the mean spacing of n generators in the box [lo, hi], which is
+    // the margin we add around the box of the generators
+    static double get_margin(unsigned long long n, unsigned int ndim,
+                             const double *lo, const double *hi){
+        double extent = 0.;
+        for(unsigned int k = 0; k < ndim; k++){
+            extent = std::max(extent, hi[k] - lo[k]);
+        }
+        if(!(extent > 0.)){
+            extent = 1.;
+        }
+        double volume = 1.;
+        for(unsigned int k = 0; k < ndim; k++){
+            volume *= std::max(hi[k] - lo[k], 1.e-3*extent);
+        }
+        return 0.5*std::pow(volume/std::max(n, 1ULL), 1./ndim);
+    }
+
+    // construct the cells of the n generators with the given positions (3
+    // per generator, z is ignored in 2D), clipped to the bounding box of the
+    // generators with a margin of half the mean generator spacing
+    void build(const float *positions, unsigned long long n,
+               unsigned int ndim){
+        double lo[3] = {0., 0., 0.};
+        double hi[3] = {0., 0., 0.};
+        if(n){
+            for(unsigned int k = 0; k < ndim; k++){
+                lo[k] = hi[k] = positions[k];
+            }
+            add_to_box(positions, n, ndim, lo, hi);
+            double margin = get_margin(n, ndim, lo, hi);
+            for(unsigned int k = 0; k < ndim; k++){
+                lo[k] -= margin;
+                hi[k] += margin;
+            }
+        }
+        build(positions, n, n, ndim, lo, hi);
+    }
+
+    // construct the cells of the first ncell of the n generators, clipped to
+    // the box [lo, hi], which has to contain all generators. The other
+    // generators are only used to cut the cells.
+    void build(const float *positions, unsigned long long n,
+               unsigned long long ncell, unsigned int ndim, const double *lo,
+               const double *hi){
+        clear();
+        _built = true;
+        _ndim = ndim;
+        for(unsigned int k = 0; k < 3; k++){
+            _reach[2*k] = k < ndim ? hi[k] : 0.;
+            _reach[2*k+1] = k < ndim ? lo[k] : 0.;
+        }
+        if(!ncell){
+            return;
+        }
+
+        double diagonal = 0.;
+        for(unsigned int k = 0; k < ndim; k++){
+            diagonal += (hi[k] - lo[k])*(hi[k] - lo[k]);
+        }
+        double eps = 1.e-12*std::sqrt(diagonal);
+
+        // the bins only cover the generators, which can be a small part of
+        // the box
+        double glo[3], ghi[3];
+        for(unsigned int k = 0; k < ndim; k++){
+            glo[k] = ghi[k] = positions[k];
+        }
+        add_to_box(positions, n, ndim, glo, ghi);
+        double margin = get_margin(n, ndim, glo, ghi);
+        for(unsigned int k = 0; k < ndim; k++){
+            glo[k] = std::max(lo[k], glo[k] - margin);
+            ghi[k] = std::min(hi[k], ghi[k] + margin);
+        }
+        BinGrid grid;
+        grid.build(positions, n, ndim, glo, ghi);
+
+        // the generators whose cells we construct, in the sorted order
+        std::vector<unsigned long long> cells;
+        cells.reserve(ncell);
+        for(unsigned long long j = 0; j < n; j++){
+            if(grid._index[j] < ncell){
+                cells.push_back(j);
+            }
+        }
+
+        long long nblock = (ncell + BLOCK_SIZE - 1)/BLOCK_SIZE;
+        _blocks.resize(nblock);
+        _nvertex.resize(ncell);
+        _nface.resize(ncell);
+        _vertex_start.resize(ncell);
+        _face_start.resize(ncell);
+#pragma omp parallel
+        {
+            Cell cell;
+            std::vector< std::pair<double, unsigned long long> > candidates;
+            double reach[6];
+            std::copy(_reach, _reach + 6, reach);
+#pragma omp for schedule(dynamic)
+            for(long long iblock = 0; iblock < nblock; iblock++){
+                Block &block = _blocks[iblock];
+                unsigned long long end = std::min(ncell,
+                    (unsigned long long)(iblock + 1)*BLOCK_SIZE);
+                for(unsigned long long i = iblock*BLOCK_SIZE; i < end; i++){
+                    construct(grid, cells[i], lo, hi, eps, cell, candidates);
+                    const double *x = &grid._positions[3*cells[i]];
+                    // generators within twice the radius of the cell can
+                    // cut it
+                    double r = 2.*std::sqrt(cell._r2);
+                    for(unsigned int k = 0; k < ndim; k++){
+                        reach[2*k] = std::min(reach[2*k], x[k] - r);
+                        reach[2*k+1] = std::max(reach[2*k+1], x[k] + r);
+                    }
+                    _nvertex[i] = cell._vertices.size()/3;
+                    _vertex_start[i] = block._vertices.size()/3;
+                    _face_start[i] = block._faces.size();
+                    for(unsigned int j = 0; j < cell._vertices.size(); j++){
+                        block._vertices.push_back(x[j%3] +
+                                                  cell._vertices[j]);
+                    }
+                    if(ndim == 3){
+                        block._faces.push_back(0);
+                        for(unsigned int j = 0; j < cell._faces.size();
+                            j += cell._faces[j] + 1){
+                            block._faces[_face_start[i]]++;
+                            block._faces.insert(block._faces.end(),
+                                &cell._faces[j],
+                                &cell._faces[j] + cell._faces[j] + 1);
+                        }
+                    }
+                    _nface[i] = block._faces.size() - _face_start[i];
+                }
+                // release the spare capacity of the buffers
+                std::vector<float>(block._vertices).swap(block._vertices);
+                std::vector<int>(block._faces).swap(block._faces);
+            }
+#pragma omp critical
+            for(unsigned int k = 0; k < ndim; k++){
+                _reach[2*k] = std::min(_reach[2*k], reach[2*k]);
+                _reach[2*k+1] = std::max(_reach[2*k+1], reach[2*k+1]);
+            }
+        }
+
+        _sorted.resize(ncell);
+        for(unsigned long long i = 0; i < ncell; i++){
+            _sorted[grid._index[cells[i]]] = i;
+        }
+    }
+
+    // the cells of the generators [begin, end[ as an unstructured grid of
+    // polygons (2D) or polyhedra (3D)
+    vtkUnstructuredGrid *get_mesh(unsigned long long begin,
+                                  unsigned long long end) const {
+        vtkIdType ncell = end - begin;
+        // the first point and face element of every cell
+        std::vector<vtkIdType> first(ncell + 1, 0);
+        std::vector<vtkIdType> firstface(ncell + 1, 0);
+        for(vtkIdType c = 0; c < ncell; c++){
+            unsigned long long i = _sorted[begin+c];
+            first[c+1] = first[c] + _nvertex[i];
+            firstface[c+1] = firstface[c] + _nface[i];
+        }
+        vtkIdType npoint = first[ncell];
+        vtkIdType nface = firstface[ncell];
+
+        vtkPoints *points = vtkPoints::New();
+        points->SetNumberOfPoints(npoint);
+        float *pts = (float*)points->GetVoidPointer(0);
+        vtkUnsignedCharArray *types = vtkUnsignedCharArray::New();
+        types->SetNumberOfValues(ncell);
+        vtkIdTypeArray *locations = vtkIdTypeArray::New();
+        locations->SetNumberOfValues(ncell);
+        vtkIdTypeArray *connectivity = vtkIdTypeArray::New();
+        connectivity->SetNumberOfValues(ncell + npoint);
+        vtkIdTypeArray *facelocations = NULL;
+        vtkIdTypeArray *faces = NULL;
+        if(_ndim == 3){
+            facelocations = vtkIdTypeArray::New();
+            facelocations->SetNumberOfValues(ncell);
+            faces = vtkIdTypeArray::New();
+            faces->SetNumberOfValues(nface);
+        }
+        unsigned char *type = types->GetPointer(0);
+        vtkIdType *location = locations->GetPointer(0);
+        vtkIdType *ids = connectivity->GetPointer(0);
+        vtkIdType *facelocation = faces ? facelocations->GetPointer(0) : NULL;
+        vtkIdType *face = faces ? faces->GetPointer(0) : NULL;
+#pragma omp parallel for schedule(static)
+        for(vtkIdType c = 0; c < ncell; c++){
+            unsigned long long i = _sorted[begin+c];
+            const Block &block = _blocks[i/BLOCK_SIZE];
+            vtkIdType count = _nvertex[i];
+            const float *vertices = &block._vertices[3*_vertex_start[i]];
+            std::copy(vertices, vertices + 3*count, pts + 3*first[c]);
+            type[c] = _ndim == 3 ? VTK_POLYHEDRON : VTK_POLYGON;
+            location[c] = c + first[c];
+            ids[c + first[c]] = count;
+            for(vtkIdType j = 0; j < count; j++){
+                ids[c + first[c] + 1 + j] = first[c] + j;
+            }
+            if(face){
+                // the face stream, with the cell vertex ids replaced by
+                // point ids
+                const int *cellfaces = &block._faces[_face_start[i]];
+                vtkIdType out = firstface[c];
+                facelocation[c] = out;
+                unsigned int f = 0;
+                face[out++] = cellfaces[f++];
+                while(f < _nface[i]){
+                    int n = cellfaces[f++];
+                    face[out++] = n;
+                    for(int j = 0; j < n; j++){
+                        face[out++] = first[c] + cellfaces[f++];
+                    }
+                }
+            }
+        }
+
+        vtkCellArray *cells = vtkCellArray::New();
+        cells->SetCells(ncell, connectivity);
+        connectivity->Delete();
+        vtkUnstructuredGrid *ugrid = vtkUnstructuredGrid::New();
+        ugrid->SetPoints(points);
+        points->Delete();
+        if(faces){
+            ugrid->SetCells(types, locations, cells, facelocations, faces);
+            facelocations->Delete();
+            faces->Delete();
+        } else {
+            ugrid->SetCells(types, locations, cells);
+        }
+        types->Delete();
+        locations->Delete();
+        cells->Delete();
+        return ugrid;
+    }
+};
+
+
+#endif